@@ -1,264 +1,3924 @@
 #include <iostream>         // Para entrada y salida estándar
 #include <fstream>          // Para manejo de archivos
 #include <vector>           // Para el uso de vectores dinámicos
-#include <list>             // Para implementar listas enlazadas (chaining en la tabla hash)
 #include <unordered_map>    // Para implementar la tabla hash
-#include <unordered_set>    // Para utilizar std::unordered_set
-#include <queue>            // Para implementar colas (FIFO)
 #include <algorithm>        // Para funciones como find()
 #include <cstring>          // Para manejo de cadenas de caracteres C
 #include <cstdlib>          // Para funciones estándar como atoi()
+#include <cstdint>          // Para enteros de tamaño fijo (uint64_t)
 #include <map>              // Para el algoritmo Óptimo
+#include <deque>            // Para la ventana de anticipación del Óptimo en modo flujo
+#include <memory>           // Para unique_ptr
+#include <thread>           // Para simular varios algoritmos en paralelo
+#include <atomic>           // Para repartir los algoritmos entre los hilos
+#include <set>              // Para ordenar las páginas por próximo uso (Óptimo)
+#include <random>           // Para generar trazas sintéticas (-g y -bench)
+#include <cmath>            // Para el muestreo de Zipf
+#include <chrono>           // Para medir el tiempo en el modo -bench
+#include <fcntl.h>          // Para open()
+#include <sys/mman.h>       // Para proyectar el archivo de referencias en memoria (mmap)
+#include <sys/stat.h>       // Para conocer el tamaño del archivo (fstat)
+#include <unistd.h>         // Para close()
+#include <cstdio>           // Para rename() al escribir puntos de control
+#include <type_traits>      // Para verificar que el estado guardado se pueda copiar byte a byte
 
 using namespace std;
 
+// Puntos de control (-punto, -reanudar): el estado de un algoritmo se vuelca tal cual está
+// en memoria (escalares y vectores de estructuras simples), así que el archivo es compacto
+// pero solo lo lee el mismo binario en la misma arquitectura; la cabecera lo verifica.
+static const char CHECKPOINT_MAGIC[4] = {'M', 'V', 'C', 'K'};
+static const uint32_t CHECKPOINT_VERSION = 2;
+
+static void failCorruptCheckpoint() {
+    cerr << "Archivo de punto de control corrupto o incompatible." << endl;
+    exit(1);
+}
+
+class CheckpointWriter {
+private:
+    ofstream out;
+
+public:
+    CheckpointWriter(const string& filename) : out(filename, ios::binary | ios::trunc) {}
+
+    bool isOpen() const { return out.is_open(); }
+
+    template <typename T>
+    void put(const T& value) {
+        static_assert(is_trivially_copyable<T>::value, "solo estado copiable byte a byte");
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void putVector(const vector<T>& values) {
+        static_assert(is_trivially_copyable<T>::value, "solo estado copiable byte a byte");
+        put<uint64_t>(values.size());
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    bool close() {
+        out.close();
+        return !out.fail();
+    }
+};
+
+class CheckpointReader {
+private:
+    ifstream in;
+    uint64_t file_size;
+
+public:
+    CheckpointReader(const string& filename) : in(filename, ios::binary | ios::ate), file_size(0) {
+        if (in.is_open()) {
+            file_size = (uint64_t)in.tellg();
+            in.seekg(0);
+        }
+    }
+
+    bool isOpen() const { return in.is_open(); }
+
+    template <typename T>
+    T get() {
+        static_assert(is_trivially_copyable<T>::value, "solo estado copiable byte a byte");
+        T value;
+        if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+            failCorruptCheckpoint();
+        }
+        return value;
+    }
+
+    // El tamaño leído se acota por lo que queda del archivo antes de reservar memoria
+    template <typename T>
+    void getVector(vector<T>& values) {
+        uint64_t size = get<uint64_t>();
+        if (size > (file_size - (uint64_t)in.tellg()) / sizeof(T)) {
+            failCorruptCheckpoint();
+        }
+        values.resize(size);
+        if (!in.read(reinterpret_cast<char*>(values.data()), size * sizeof(T))) {
+            failCorruptCheckpoint();
+        }
+    }
+};
+
+// Al cargar un punto de control los índices se verifican antes de usarlos: un archivo
+// dañado se informa como corrupto en vez de leer fuera de los arreglos
+static void checkIndex(long long index, size_t size) {
+    if (index < -1 || index >= (long long)size) {
+        failCorruptCheckpoint();
+    }
+}
+
+// Los bool y enum se leen byte a byte del archivo: verificar su representación antes de
+// usarlos como valores
+static void checkBool(const bool& value) {
+    unsigned char raw;
+    memcpy(&raw, &value, 1);
+    if (raw > 1) {
+        failCorruptCheckpoint();
+    }
+}
+
+template <typename Enum>
+void checkEnum(const Enum& value, int first, int last) {
+    typename underlying_type<Enum>::type raw;
+    memcpy(&raw, &value, sizeof(raw));
+    if ((long long)raw < first || (long long)raw > last) {
+        failCorruptCheckpoint();
+    }
+}
+
+// Recorrer una lista doblemente enlazada guardada en un arreglo de nodos con campos prev y
+// next, verificando índices en rango y enlaces recíprocos. visited (del tamaño de nodes)
+// marca los nodos ya vistos, así un ciclo o un nodo compartido entre listas se detecta.
+// Suma a length los nodos recorridos y devuelve el último (-1 si la lista está vacía).
+template <typename Node>
+int checkLinkedList(const vector<Node>& nodes, int head, vector<bool>& visited, size_t& length) {
+    int last = -1;
+    for (int node = head; node != -1; node = nodes[node].next) {
+        checkIndex(node, nodes.size());
+        if (visited[node] || nodes[node].prev != last) {
+            failCorruptCheckpoint();
+        }
+        visited[node] = true;
+        last = node;
+        length++;
+    }
+    return last;
+}
+
+// Marcar como vistos los nodos de una lista de libres (no pueden estar en otra lista)
+static void checkFreeList(const vector<int>& free_list, vector<bool>& visited) {
+    for (int node : free_list) {
+        checkIndex(node, visited.size());
+        if (node == -1 || visited[node]) {
+            failCorruptCheckpoint();
+        }
+        visited[node] = true;
+    }
+}
+
 // Estructura para representar una entrada en la tabla de páginas
 struct PageTableEntry {
-    int page_number;    // Número de página virtual
+    int page_number;    // Número de página virtual (-1 indica casilla libre en la tabla)
     bool valid;         // Bit de validez
-    // Se pueden agregar más campos si es necesario (por ejemplo, bits de uso para LRU Reloj)
+    int frame;          // Marco físico donde está cargada la página
+};
+
+// Clase para implementar la tabla de páginas como una tabla hash plana con
+// direccionamiento abierto (sondeo lineal). Las entradas viven contiguas en un solo
+// vector de capacidad potencia de dos, que se duplica al superar 3/4 de ocupación;
+// las eliminaciones desplazan hacia atrás las entradas siguientes (sin lápidas).
+class PageTable {
+private:
+    static const int EMPTY = -1;
+
+    vector<PageTableEntry> table;  // Casillas de la tabla hash
+    size_t mask;                   // Capacidad - 1
+    size_t count;                  // Entradas ocupadas
+
+    size_t slotFor(int page_number) const {
+        return hashFunction(page_number) & mask;
+    }
+
+    // Duplicar la capacidad y volver a ubicar todas las entradas
+    void grow() {
+        vector<PageTableEntry> old_table;
+        old_table.swap(table);
+        table.assign(old_table.size() * 2, {EMPTY, false, -1});
+        mask = table.size() - 1;
+        for (const PageTableEntry& entry : old_table) {
+            if (entry.page_number != EMPTY) {
+                size_t i = slotFor(entry.page_number);
+                while (table[i].page_number != EMPTY) {
+                    i = (i + 1) & mask;
+                }
+                table[i] = entry;
+            }
+        }
+    }
+
+public:
+    // Constructor: expected_entries es una estimación de cuántas páginas habrá a la vez
+    PageTable(size_t expected_entries = 16) : count(0) {
+        size_t capacity = 16;
+        while (capacity * 3 < expected_entries * 4) {
+            capacity <<= 1;
+        }
+        table.assign(capacity, {EMPTY, false, -1});
+        mask = capacity - 1;
+    }
+
+    // Función hash: finalizador de MurmurHash3, dispersa bien páginas consecutivas
+    static uint32_t hashFunction(int page_number) {
+        uint32_t h = (uint32_t)page_number;
+        h ^= h >> 16;
+        h *= 0x85EBCA6BU;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35U;
+        h ^= h >> 16;
+        return h;
+    }
+
+    // Buscar la entrada de una página; nullptr si no está en la tabla
+    PageTableEntry* find(int page_number) {
+        for (size_t i = slotFor(page_number);; i = (i + 1) & mask) {
+            if (table[i].page_number == page_number) {
+                return &table[i];
+            }
+            if (table[i].page_number == EMPTY) {
+                return nullptr;
+            }
+        }
+    }
+
+    const PageTableEntry* find(int page_number) const {
+        return const_cast<PageTable*>(this)->find(page_number);
+    }
+
+    // Insertar (o revalidar) una entrada de la tabla de páginas
+    PageTableEntry* insert(int page_number, int frame = -1) {
+        PageTableEntry* entry = find(page_number);
+        if (entry == nullptr) {
+            if ((count + 1) * 4 > table.size() * 3) {
+                grow();
+            }
+            size_t i = slotFor(page_number);
+            while (table[i].page_number != EMPTY) {
+                i = (i + 1) & mask;
+            }
+            entry = &table[i];
+            entry->page_number = page_number;
+            count++;
+        }
+        entry->valid = true;
+        entry->frame = frame;
+        return entry;
+    }
+
+    // Eliminar una entrada de la tabla de páginas
+    void remove(int page_number) {
+        size_t i = slotFor(page_number);
+        while (table[i].page_number != page_number) {
+            if (table[i].page_number == EMPTY) {
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+        for (size_t j = (i + 1) & mask; table[j].page_number != EMPTY; j = (j + 1) & mask) {
+            size_t home = slotFor(table[j].page_number);
+            // Mover la entrada j al hueco i si su posición ideal no está entre (i, j]
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                table[i] = table[j];
+                i = j;
+            }
+        }
+        table[i].page_number = EMPTY;
+        count--;
+    }
+
+    // Verificar si una página está en la tabla y es válida
+    bool isValid(int page_number) const {
+        const PageTableEntry* entry = find(page_number);
+        return entry != nullptr && entry->valid;
+    }
+
+    // Marcar la página como no cargada, conservando su entrada
+    void invalidate(int page_number) {
+        PageTableEntry* entry = find(page_number);
+        if (entry != nullptr) {
+            entry->valid = false;
+        }
+    }
+
+    // Casillas que hay que leer para encontrar la página (o saber que no está)
+    size_t probeCount(int page_number) const {
+        size_t probes = 1;
+        for (size_t i = slotFor(page_number); table[i].page_number != page_number && table[i].page_number != EMPTY;
+             i = (i + 1) & mask) {
+            probes++;
+        }
+        return probes;
+    }
+
+    // Marco de una página válida, o -1 si no está cargada
+    int frameOf(int page_number) const {
+        const PageTableEntry* entry = find(page_number);
+        return (entry != nullptr && entry->valid) ? entry->frame : -1;
+    }
+
+    size_t size() const { return count; }
+
+    // Volcar y recuperar la tabla completa para los puntos de control
+    void save(CheckpointWriter& out) const {
+        out.putVector(table);
+        out.put(count);
+    }
+
+    // Además de la forma de la tabla se verifica que cada entrada ocupada se encuentre desde
+    // su casilla ideal (sin duplicados) y que count sea exacto, así queda al menos una casilla
+    // libre y las búsquedas terminan
+    void load(CheckpointReader& in) {
+        in.getVector(table);
+        count = in.get<size_t>();
+        if (table.empty() || (table.size() & (table.size() - 1)) != 0 || count >= table.size()) {
+            failCorruptCheckpoint();
+        }
+        mask = table.size() - 1;
+        size_t occupied = 0;
+        for (const PageTableEntry& entry : table) {
+            checkBool(entry.valid);
+            if (entry.page_number != EMPTY) {
+                occupied++;
+            }
+        }
+        if (occupied != count) {
+            failCorruptCheckpoint();
+        }
+        for (const PageTableEntry& entry : table) {
+            if (entry.page_number != EMPTY && find(entry.page_number) != &entry) {
+                failCorruptCheckpoint();
+            }
+        }
+    }
+
+    // Verificar que el marco (o nodo) de cada página válida esté en [0, limit) y cumpla
+    // check(página, marco); para validar un punto de control contra el estado del algoritmo
+    template <typename Check>
+    void checkFrames(size_t limit, Check check) const {
+        for (const PageTableEntry& entry : table) {
+            if (entry.page_number == EMPTY || !entry.valid) {
+                continue;
+            }
+            if (entry.frame < 0 || (size_t)entry.frame >= limit || !check(entry.page_number, entry.frame)) {
+                failCorruptCheckpoint();
+            }
+        }
+    }
+};
+
+// Archivo proyectado en memoria (solo lectura) para leer la traza sin copias
+class MappedFile {
+private:
+    int fd;
+    const char* data;
+    size_t length;
+
+public:
+    MappedFile(const string& filename) : fd(-1), data(nullptr), length(0) {
+        fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            fd = -1;
+            return;
+        }
+        length = (size_t)info.st_size;
+        if (length == 0) {
+            return;  // mmap no acepta largo 0: un archivo vacío es una traza vacía
+        }
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            fd = -1;
+            return;
+        }
+        madvise(mapping, length, MADV_SEQUENTIAL);  // Se recorre una sola vez de inicio a fin
+        data = static_cast<const char*>(mapping);
+    }
+
+    ~MappedFile() {
+        if (data != nullptr) {
+            munmap(const_cast<char*>(data), length);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+};
+
+static inline bool isSeparator(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+// Cuenta los números del texto (transiciones separador -> dígito) para reservar el vector una vez
+size_t countReferences(const char* begin, const char* end) {
+    size_t count = 0;
+    bool in_number = false;
+    for (const char* p = begin; p != end; ++p) {
+        bool separator = isSeparator(*p);
+        count += (!separator && !in_number);
+        in_number = !separator;
+    }
+    return count;
+}
+
+// Recorre el texto y llama a emit(página) por cada número, sin pasar por iostream ni locale.
+// Termina el programa si encuentra algo que no sea un número de página no negativo.
+// offset es la posición de begin dentro del archivo, para informar errores al leer por bloques.
+template <typename Emit>
+void parseReferences(const char* begin, const char* end, Emit emit, size_t offset = 0) {
+    const char* p = begin;
+    while (true) {
+        while (p != end && isSeparator(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            return;
+        }
+        const char* token = p;
+        uint64_t value = 0;
+        while (p != end && (unsigned)(*p - '0') < 10) {
+            value = value * 10 + (unsigned)(*p - '0');
+            if (value > (uint64_t)INT32_MAX) {
+                break;
+            }
+            ++p;
+        }
+        if (p == token || value > (uint64_t)INT32_MAX || (p != end && !isSeparator(*p))) {
+            cerr << "Referencia inválida en la posición " << offset + (token - begin) << " del archivo." << endl;
+            exit(1);
+        }
+        emit((int)value);
+    }
+}
+
+// Formato binario de trazas (.mvt):
+//   cabecera de 16 bytes: "MVTB", versión (uint32) y total de referencias (uint64)
+//   bloques: cantidad (uint32), bytes del contenido (uint32) y el contenido, donde cada
+//   página se guarda como la diferencia con la anterior del bloque, en zigzag + varint.
+// Cada bloque empieza con diferencia respecto de 0, así se puede decodificar por separado.
+// Todos los enteros de tamaño fijo van en little endian.
+static const char BINARY_TRACE_MAGIC[4] = {'M', 'V', 'T', 'B'};
+static const uint32_t BINARY_TRACE_VERSION = 1;
+static const size_t BINARY_TRACE_HEADER_SIZE = 16;
+static const uint32_t BINARY_TRACE_BLOCK_REFERENCES = 65536;
+static const uint32_t BINARY_TRACE_MAX_VARINT_BYTES = 5;  // Un delta entre páginas de 31 bits en zigzag
+
+static inline uint64_t loadLittleEndian(const char* p, int bytes) {
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = (value << 8) | (unsigned char)p[i];
+    }
+    return value;
+}
+
+static inline void storeLittleEndian(char* p, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        p[i] = (char)(value >> (8 * i));
+    }
+}
+
+bool isBinaryTrace(const char* begin, const char* end) {
+    return (size_t)(end - begin) >= BINARY_TRACE_HEADER_SIZE && memcmp(begin, BINARY_TRACE_MAGIC, 4) == 0;
+}
+
+// Escritor incremental de trazas binarias: acumula un bloque y lo escribe al completarse.
+// El total de la cabecera se completa en close(), por eso la salida debe ser un archivo.
+class BinaryTraceWriter {
+private:
+    ofstream out;
+    vector<char> payload;      // Contenido codificado del bloque en curso
+    uint32_t block_count;      // Referencias en el bloque en curso
+    int previous;              // Última página del bloque en curso
+    uint64_t total;            // Referencias escritas en total
+
+    void flushBlock() {
+        if (block_count == 0) {
+            return;
+        }
+        char block_header[8];
+        storeLittleEndian(block_header, block_count, 4);
+        storeLittleEndian(block_header + 4, payload.size(), 4);
+        out.write(block_header, sizeof(block_header));
+        out.write(payload.data(), payload.size());
+        payload.clear();
+        block_count = 0;
+        previous = 0;
+    }
+
+public:
+    BinaryTraceWriter(const string& filename)
+        : out(filename, ios::binary | ios::trunc), block_count(0), previous(0), total(0) {
+        char header[BINARY_TRACE_HEADER_SIZE];
+        memcpy(header, BINARY_TRACE_MAGIC, 4);
+        storeLittleEndian(header + 4, BINARY_TRACE_VERSION, 4);
+        storeLittleEndian(header + 8, 0, 8);  // Se completa al cerrar
+        out.write(header, sizeof(header));
+        payload.reserve(BINARY_TRACE_BLOCK_REFERENCES * 2);
+    }
+
+    bool isOpen() const { return out.is_open(); }
+
+    void append(int page_number) {
+        int64_t delta = (int64_t)page_number - previous;
+        uint64_t zigzag = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+        while (zigzag >= 0x80) {
+            payload.push_back((char)(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        payload.push_back((char)zigzag);
+        previous = page_number;
+        total++;
+        if (++block_count == BINARY_TRACE_BLOCK_REFERENCES) {
+            flushBlock();
+        }
+    }
+
+    // Escribe el último bloque y el total de referencias; devuelve false si hubo error de E/S
+    bool close() {
+        flushBlock();
+        char count[8];
+        storeLittleEndian(count, total, 8);
+        out.seekp(8);
+        out.write(count, sizeof(count));
+        out.close();
+        return !out.fail();
+    }
+
+    uint64_t written() const { return total; }
+};
+
+static void failCorruptBinaryTrace() {
+    cerr << "Archivo binario de referencias corrupto." << endl;
+    exit(1);
+}
+
+// Verificar la cabecera de un bloque antes de reservar memoria para él: cada referencia
+// ocupa entre 1 y BINARY_TRACE_MAX_VARINT_BYTES bytes, un bloque no tiene más referencias
+// que las del formato ni más que las que faltan según la cabecera de la traza, y su
+// contenido debe caber en lo que queda del archivo
+static void checkBinaryBlockHeader(uint32_t block_count, uint32_t block_bytes, uint64_t decoded, uint64_t expected,
+                                   uint64_t remaining_bytes) {
+    if (block_count > BINARY_TRACE_BLOCK_REFERENCES || block_count > block_bytes ||
+        (uint64_t)block_bytes > (uint64_t)block_count * BINARY_TRACE_MAX_VARINT_BYTES ||
+        block_count > expected - decoded || block_bytes > remaining_bytes) {
+        failCorruptBinaryTrace();
+    }
+}
+
+// Decodifica el contenido de un bloque [p, block_end) con block_count referencias
+template <typename Emit>
+void decodeBinaryBlock(const char* p, const char* block_end, uint32_t block_count, Emit emit) {
+    int64_t page_number = 0;
+    for (uint32_t i = 0; i < block_count; ++i) {
+        uint64_t zigzag = 0;
+        int shift = 0;
+        while (p != block_end && shift < 64) {
+            unsigned char byte = (unsigned char)*p++;
+            zigzag |= (uint64_t)(byte & 0x7F) << shift;
+            shift += 7;
+            if ((byte & 0x80) == 0) {
+                shift = -1;  // Marca de varint completo
+                break;
+            }
+        }
+        // Verificar el rango del delta antes de sumarlo, así un varint malformado no
+        // desborda el acumulador
+        int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+        if (shift != -1 || delta < -page_number || delta > INT32_MAX - page_number) {
+            failCorruptBinaryTrace();
+        }
+        page_number += delta;
+        emit((int)page_number);
+    }
+    if (p != block_end) {
+        failCorruptBinaryTrace();
+    }
+}
+
+static void checkBinaryTraceVersion(const char* header) {
+    if (loadLittleEndian(header + 4, 4) != BINARY_TRACE_VERSION) {
+        cerr << "Versión de traza binaria no soportada." << endl;
+        exit(1);
+    }
+}
+
+// Recorre una traza binaria y llama a emit(página) por cada referencia.
+// Termina el programa si el archivo está truncado o no es de una versión conocida.
+template <typename Emit>
+void decodeBinaryTrace(const char* begin, const char* end, Emit emit) {
+    checkBinaryTraceVersion(begin);
+    uint64_t expected = loadLittleEndian(begin + 8, 8);
+    uint64_t decoded = 0;
+    const char* p = begin + BINARY_TRACE_HEADER_SIZE;
+
+    while (end - p >= 8) {
+        uint32_t block_count = (uint32_t)loadLittleEndian(p, 4);
+        uint32_t block_bytes = (uint32_t)loadLittleEndian(p + 4, 4);
+        p += 8;
+        checkBinaryBlockHeader(block_count, block_bytes, decoded, expected, end - p);
+        decodeBinaryBlock(p, p + block_bytes, block_count, emit);
+        decoded += block_count;
+        p += block_bytes;
+    }
+
+    if (p != end || decoded != expected) {
+        failCorruptBinaryTrace();
+    }
+}
+
+// Función para leer las referencias de página desde un archivo (texto o binario .mvt)
+vector<int> readReferences(const string& filename) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        cerr << "No se pudo abrir el archivo de referencias." << endl;
+        exit(1);
+    }
+
+    vector<int> references;
+    auto append = [&references](int page_number) {
+        references.push_back(page_number);
+    };
+    if (isBinaryTrace(file.begin(), file.end())) {
+        // Cada referencia ocupa al menos un byte: el total de la cabecera no puede superar
+        // lo que cabe en el archivo (si lo supera, decodeBinaryTrace lo informa como corrupto)
+        uint64_t stored_bytes = file.end() - file.begin() - BINARY_TRACE_HEADER_SIZE;
+        references.reserve(min(loadLittleEndian(file.begin() + 8, 8), stored_bytes));
+        decodeBinaryTrace(file.begin(), file.end(), append);
+    } else {
+        references.reserve(countReferences(file.begin(), file.end()));
+        parseReferences(file.begin(), file.end(), append);
+    }
+    return references;
+}
+
+// Fuente de referencias leída por bloques, para simular sin cargar la traza completa.
+// La memoria usada queda acotada por el tamaño de un bloque.
+class TraceSource {
+public:
+    virtual ~TraceSource() {}
+
+    // Reemplaza el contenido de chunk con las siguientes referencias; false al terminar la traza
+    virtual bool next(vector<int>& chunk) = 0;
+};
+
+// Traza de texto leída con read() en bloques de tamaño fijo. Un número que queda cortado
+// al final de un bloque se guarda y se completa con el bloque siguiente.
+class TextTraceSource : public TraceSource {
+private:
+    static const size_t CHUNK_BYTES = 1 << 20;
+
+    int fd;
+    vector<char> buffer;
+    size_t pending;      // Bytes de un número incompleto al inicio de buffer
+    size_t offset;       // Posición en el archivo del inicio de buffer
+    bool finished;
+
+public:
+    TextTraceSource(int file_descriptor)
+        : fd(file_descriptor), buffer(CHUNK_BYTES), pending(0), offset(0), finished(false) {}
+
+    ~TextTraceSource() { close(fd); }
+
+    bool next(vector<int>& chunk) override {
+        chunk.clear();
+        while (chunk.empty() && !finished) {
+            ssize_t bytes = read(fd, buffer.data() + pending, buffer.size() - pending);
+            if (bytes < 0) {
+                cerr << "Error al leer el archivo de referencias." << endl;
+                exit(1);
+            }
+            size_t filled = pending + (size_t)bytes;
+            size_t complete = filled;  // Hasta dónde hay números completos
+            if (bytes == 0) {
+                finished = true;
+            } else {
+                while (complete > 0 && !isSeparator(buffer[complete - 1])) {
+                    complete--;
+                }
+                if (complete == 0 && filled == buffer.size()) {
+                    buffer.resize(buffer.size() * 2);  // Un solo "número" ocupa todo el bloque
+                }
+            }
+            auto append = [&chunk](int page_number) {
+                chunk.push_back(page_number);
+            };
+            parseReferences(buffer.data(), buffer.data() + complete, append, offset);
+            pending = filled - complete;
+            memmove(buffer.data(), buffer.data() + complete, pending);
+            offset += complete;
+        }
+        return !chunk.empty();
+    }
+};
+
+// Traza binaria .mvt leída bloque a bloque
+class BinaryTraceSource : public TraceSource {
+private:
+    ifstream in;
+    vector<char> payload;
+    uint64_t expected;   // Total indicado en la cabecera
+    uint64_t decoded;
+    uint64_t remaining;  // Bytes del archivo que quedan por leer
+
+public:
+    BinaryTraceSource(const string& filename)
+        : in(filename, ios::binary | ios::ate), expected(0), decoded(0), remaining(0) {
+        if (in.is_open()) {
+            remaining = (uint64_t)in.tellg();
+            in.seekg(0);
+        }
+        char header[BINARY_TRACE_HEADER_SIZE];
+        if (!in.read(header, sizeof(header))) {
+            failCorruptBinaryTrace();
+        }
+        checkBinaryTraceVersion(header);
+        expected = loadLittleEndian(header + 8, 8);
+        remaining -= BINARY_TRACE_HEADER_SIZE;
+    }
+
+    bool next(vector<int>& chunk) override {
+        chunk.clear();
+        char block_header[8];
+        if (!in.read(block_header, sizeof(block_header))) {
+            if (in.gcount() != 0 || decoded != expected) {
+                failCorruptBinaryTrace();
+            }
+            return false;
+        }
+        uint32_t block_count = (uint32_t)loadLittleEndian(block_header, 4);
+        uint32_t block_bytes = (uint32_t)loadLittleEndian(block_header + 4, 4);
+        remaining -= sizeof(block_header);
+        checkBinaryBlockHeader(block_count, block_bytes, decoded, expected, remaining);
+        remaining -= block_bytes;
+        payload.resize(block_bytes);
+        if (!in.read(payload.data(), block_bytes)) {
+            failCorruptBinaryTrace();
+        }
+        chunk.reserve(block_count);
+        decodeBinaryBlock(payload.data(), payload.data() + block_bytes, block_count, [&chunk](int page_number) {
+            chunk.push_back(page_number);
+        });
+        decoded += block_count;
+        return true;
+    }
+};
+
+// Abre la traza como texto o binaria según sus primeros bytes
+unique_ptr<TraceSource> openTraceSource(const string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "No se pudo abrir el archivo de referencias." << endl;
+        exit(1);
+    }
+    char magic[4];
+    ssize_t bytes = pread(fd, magic, sizeof(magic), 0);
+    if (bytes == (ssize_t)sizeof(magic) && memcmp(magic, BINARY_TRACE_MAGIC, 4) == 0) {
+        close(fd);
+        return unique_ptr<TraceSource>(new BinaryTraceSource(filename));
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return unique_ptr<TraceSource>(new TextTraceSource(fd));
+}
+
+// Modelos de localidad del generador de trazas sintéticas (-g)
+enum SyntheticPattern { PATTERN_UNIFORM, PATTERN_ZIPF, PATTERN_PHASES, PATTERN_LOOP, PATTERN_SCAN, PATTERN_MARKOV };
+
+// Descripción de una traza sintética: MODELO:REFERENCIAS:PÁGINAS[:PARÁMETRO[:PARÁMETRO2]]
+struct SyntheticSpec {
+    SyntheticPattern pattern;
+    uint64_t length;       // Referencias a generar
+    int pages;             // Páginas distintas posibles
+    double parameter;      // zipf: exponente; fases: tamaño del conjunto; ciclo: paso; markov: prob. local
+    uint64_t phase_length; // fases: referencias por fase
+    uint32_t seed;
+};
+
+bool parseSyntheticSpec(const string& text, uint32_t seed, SyntheticSpec& spec) {
+    static const struct {
+        const char* name;
+        SyntheticPattern pattern;
+    } MODELS[] = {
+        {"uniforme", PATTERN_UNIFORM}, {"zipf", PATTERN_ZIPF},     {"fases", PATTERN_PHASES},
+        {"ciclo", PATTERN_LOOP},       {"recorrido", PATTERN_SCAN}, {"markov", PATTERN_MARKOV},
+    };
+    vector<string> fields;
+    for (size_t start = 0;;) {
+        size_t colon = text.find(':', start);
+        fields.push_back(text.substr(start, colon - start));
+        if (colon == string::npos) {
+            break;
+        }
+        start = colon + 1;
+    }
+    size_t model = 0;
+    while (model < sizeof(MODELS) / sizeof(MODELS[0]) && fields[0] != MODELS[model].name) {
+        ++model;
+    }
+    if (model == sizeof(MODELS) / sizeof(MODELS[0]) || fields.size() < 3 || fields.size() > 5) {
+        return false;
+    }
+    spec.pattern = MODELS[model].pattern;
+    spec.length = strtoull(fields[1].c_str(), nullptr, 10);
+    long long pages = atoll(fields[2].c_str());
+    if (spec.length == 0 || pages <= 0 || pages > INT32_MAX) {
+        return false;
+    }
+    spec.pages = (int)pages;
+    spec.seed = seed;
+    switch (spec.pattern) {
+    case PATTERN_ZIPF:   spec.parameter = 1.0; break;
+    case PATTERN_PHASES: spec.parameter = max(1, spec.pages / 16); break;
+    case PATTERN_LOOP:   spec.parameter = 1; break;
+    case PATTERN_MARKOV: spec.parameter = 0.9; break;
+    default:             spec.parameter = 0; break;
+    }
+    spec.phase_length = max<uint64_t>(1, spec.length / 10);
+    if (fields.size() > 3) {
+        spec.parameter = atof(fields[3].c_str());
+    }
+    if (fields.size() > 4) {
+        spec.phase_length = strtoull(fields[4].c_str(), nullptr, 10);
+    }
+    switch (spec.pattern) {
+    case PATTERN_ZIPF:   return spec.parameter > 0;
+    case PATTERN_PHASES: return spec.parameter >= 1 && spec.parameter <= spec.pages && spec.phase_length > 0;
+    case PATTERN_LOOP:   return spec.parameter >= 1;
+    case PATTERN_MARKOV: return spec.parameter >= 0 && spec.parameter <= 1;
+    default:             return fields.size() == 3;
+    }
+}
+
+// Muestreo de Zipf por rechazo-inversión (Hörmann y Derflinger): memoria constante y
+// costo esperado O(1) por muestra, así sirve también para millones de páginas.
+class ZipfSampler {
+private:
+    double exponent;
+    double h_integral_x1;
+    double h_integral_n;
+    double threshold;
+    int n;
+
+    // log1p(x) / x y expm1(x) / x, estables cerca de 0
+    static double helper1(double x) {
+        return fabs(x) > 1e-8 ? log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+    static double helper2(double x) {
+        return fabs(x) > 1e-8 ? expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+    }
+    double h(double x) const { return exp(-exponent * log(x)); }
+    double hIntegral(double x) const {
+        double log_x = log(x);
+        return helper2((1.0 - exponent) * log_x) * log_x;
+    }
+    double hIntegralInverse(double x) const {
+        double t = max(-1.0, x * (1.0 - exponent));
+        return exp(helper1(t) * x);
+    }
+
+public:
+    ZipfSampler(int pages, double s) : exponent(s), n(pages) {
+        h_integral_x1 = hIntegral(1.5) - 1.0;
+        h_integral_n = hIntegral(pages + 0.5);
+        threshold = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+    }
+
+    // Rango 0..pages-1; el rango 0 es la página más popular
+    template <typename Generator>
+    int operator()(Generator& rng) {
+        uniform_real_distribution<double> uniform(0.0, 1.0);
+        while (true) {
+            double u = h_integral_n + uniform(rng) * (h_integral_x1 - h_integral_n);
+            double x = hIntegralInverse(u);
+            double k = floor(x + 0.5);
+            k = min(max(k, 1.0), (double)n);
+            if (k - x <= threshold || u >= hIntegral(k + 0.5) - h(k)) {
+                return (int)k - 1;
+            }
+        }
+    }
+};
+
+// Fuente de referencias sintéticas generadas al vuelo, por bloques: se puede simular o
+// convertir a .mvt una traza de miles de millones de referencias sin guardarla.
+class SyntheticTraceSource : public TraceSource {
+private:
+    static const size_t CHUNK_REFERENCES = 1 << 16;
+
+    SyntheticSpec spec;
+    mt19937_64 rng;
+    ZipfSampler zipf;
+    uint64_t generated;
+    int current;          // Última página (markov) o base del conjunto de trabajo (fases)
+
+    int nextPage() {
+        switch (spec.pattern) {
+        case PATTERN_UNIFORM:
+            return (int)(rng() % (uint64_t)spec.pages);
+        case PATTERN_ZIPF:
+            return zipf(rng);
+        case PATTERN_PHASES:
+            // Cada fase usa un conjunto de trabajo contiguo en una posición nueva
+            if (generated % spec.phase_length == 0) {
+                current = (int)(rng() % (uint64_t)(spec.pages - (int)spec.parameter + 1));
+            }
+            return current + (int)(rng() % (uint64_t)spec.parameter);
+        case PATTERN_LOOP:
+            return (int)((generated * (uint64_t)spec.parameter) % (uint64_t)spec.pages);
+        case PATTERN_SCAN:
+            return (int)(generated % INT32_MAX);
+        case PATTERN_MARKOV: {
+            // Con probabilidad parameter se salta a una página vecina; si no, a cualquiera
+            uniform_real_distribution<double> uniform(0.0, 1.0);
+            if (uniform(rng) < spec.parameter) {
+                int step = (int)(rng() % 17) - 8;
+                current = (int)(((long long)current + step + spec.pages) % spec.pages);
+            } else {
+                current = (int)(rng() % (uint64_t)spec.pages);
+            }
+            return current;
+        }
+        }
+        return 0;
+    }
+
+public:
+    SyntheticTraceSource(const SyntheticSpec& synthetic)
+        : spec(synthetic), rng(synthetic.seed),
+          zipf(synthetic.pages, synthetic.pattern == PATTERN_ZIPF ? synthetic.parameter : 1.0),
+          generated(0), current(0) {}
+
+    bool next(vector<int>& chunk) override {
+        chunk.clear();
+        if (generated == spec.length) {
+            return false;
+        }
+        size_t count = (size_t)min((uint64_t)CHUNK_REFERENCES, spec.length - generated);
+        chunk.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            chunk.push_back(nextPage());
+            generated++;
+        }
+        return true;
+    }
+};
+
+// Lee una fuente completa a memoria (para los modos que necesitan toda la traza)
+vector<int> readAllReferences(TraceSource& source) {
+    vector<int> references;
+    vector<int> chunk;
+    while (source.next(chunk)) {
+        references.insert(references.end(), chunk.begin(), chunk.end());
+    }
+    return references;
+}
+
+// Convierte una traza (texto o binaria) al formato binario .mvt, leyéndola por bloques
+int convertTrace(TraceSource& source, const string& output_filename) {
+    BinaryTraceWriter writer(output_filename);
+    if (!writer.isOpen()) {
+        cerr << "No se pudo crear el archivo " << output_filename << endl;
+        return 1;
+    }
+    vector<int> chunk;
+    while (source.next(chunk)) {
+        for (int page_number : chunk) {
+            writer.append(page_number);
+        }
+    }
+    if (!writer.close()) {
+        cerr << "Error al escribir el archivo " << output_filename << endl;
+        return 1;
+    }
+    cout << "Traza convertida: " << writer.written() << " referencias escritas en " << output_filename << endl;
+    return 0;
+}
+
+// Función para calcular, para cada posición i, la siguiente posición donde se
+// vuelve a referenciar la misma página (references.size() si no se vuelve a usar).
+// Se construye en una sola pasada hacia atrás.
+vector<size_t> computeNextUse(const vector<int>& references) {
+    size_t n = references.size();
+    vector<size_t> next_use(n);
+    unordered_map<int, size_t> last_seen;  // Página -> posición más cercana hacia adelante
+    last_seen.reserve(n);
+
+    for (size_t i = n; i-- > 0;) {
+        auto it = last_seen.find(references[i]);
+        next_use[i] = (it != last_seen.end()) ? it->second : n;
+        last_seen[references[i]] = i;
+    }
+    return next_use;
+}
+
+// Cantidad máxima de entradas que se reservan por adelantado en las tablas de los algoritmos
+static const size_t MAX_RESERVED_FRAMES = 1 << 20;
+
+// Observador de la simulación: recibe cada referencia y cada expulsión. Se usa para los
+// modelos que miran la simulación desde afuera (por ejemplo la traducción de direcciones).
+// Solo se paga la llamada virtual cuando se pide un observador; sin él, el ciclo usa
+// NullObserver y no queda ningún costo extra.
+class ReferenceObserver {
+public:
+    virtual ~ReferenceObserver() {}
+    virtual void onReference(int page, bool fault) = 0;  // Después de resolver la referencia
+    virtual void onEvict(int page) = 0;                  // Antes de cargar la página nueva
+};
+
+struct NullObserver {
+    void onReference(int, bool) {}
+    void onEvict(int) {}
+};
+
+// Base común de los algoritmos de reemplazo (CRTP). El ciclo de referencias se escribe una
+// sola vez aquí y se instancia por algoritmo, así los ganchos de la clase derivada se
+// expanden en línea, sin llamadas virtuales por referencia. La clase derivada implementa:
+//   bool touch(int page)   true si la página está residente (y registra el acierto)
+//   bool isFull()          true si no quedan marcos libres
+//   int evict()            expulsa una víctima, dejando un marco libre; devuelve la página
+//   void insert(int page)  carga la página en un marco libre
+// y puede redefinir prepare() si necesita ver la traza completa antes de simular, o
+// extraEviction() si una expulsión puede sacar más de una página (devuelve -1 al terminar).
+// Para los puntos de control implementa además save(CheckpointWriter&) y
+// load(CheckpointReader&), que vuelcan y recuperan el estado entre dos referencias (load
+// verifica cada índice restaurado), y redefine resumableAt(offset) si guarda su propia
+// posición en la traza, para comprobar que coincide con la de la cabecera.
+template <typename Derived>
+class ReplacementPolicy {
+public:
+    // Procesa una referencia; devuelve true si hubo fallo de página
+    template <typename Observer>
+    bool access(int page, Observer& observer) {
+        Derived& self = static_cast<Derived&>(*this);
+        if (self.touch(page)) {
+            observer.onReference(page, false);
+            return false;
+        }
+        if (self.isFull()) {
+            observer.onEvict(self.evict());
+            for (int extra = self.extraEviction(); extra != -1; extra = self.extraEviction()) {
+                observer.onEvict(extra);
+            }
+        }
+        self.insert(page);
+        observer.onReference(page, true);
+        return true;
+    }
+
+    bool access(int page) {
+        NullObserver none;
+        return access(page, none);
+    }
+
+    template <typename Observer>
+    long long run(const int* begin, const int* end, Observer& observer) {
+        long long page_faults = 0;
+        for (const int* p = begin; p != end; ++p) {
+            page_faults += access(*p, observer);
+        }
+        return page_faults;
+    }
+
+    // Simula la traza completa en memoria
+    template <typename Observer>
+    long long run(const vector<int>& references, Observer& observer) {
+        static_cast<Derived&>(*this).prepare(references);
+        return run(references.data(), references.data() + references.size(), observer);
+    }
+
+    // Simulación en modo flujo: lee la traza por bloques y la entrega al algoritmo,
+    // sin mantener nunca la traza completa en memoria
+    template <typename Observer>
+    long long run(TraceSource& source, Observer& observer) {
+        long long page_faults = 0;
+        vector<int> chunk;
+        while (source.next(chunk)) {
+            page_faults += run(chunk.data(), chunk.data() + chunk.size(), observer);
+        }
+        return page_faults;
+    }
+
+    template <typename Input>
+    long long run(Input& input) {
+        NullObserver none;
+        return run(input, none);
+    }
+
+    void prepare(const vector<int>&) {}
+    int extraEviction() { return -1; }
+    bool resumableAt(uint64_t) const { return true; }
+};
+
+// Algoritmo FIFO: se expulsa la página que lleva más tiempo en memoria.
+// Los marcos se usan como un anillo: la víctima siempre es el marco siguiente al último reemplazado.
+class FIFOPolicy : public ReplacementPolicy<FIFOPolicy> {
+private:
+    size_t num_frames;
+    vector<int> frames;    // Marco -> página; crece hasta num_frames a medida que se ocupan
+    size_t oldest;         // Marco con la página más antigua
+    PageTable page_table;  // Página residente -> marco
+
+public:
+    FIFOPolicy(int frames_count)
+        : num_frames(frames_count), oldest(0), page_table(min(num_frames, MAX_RESERVED_FRAMES)) {
+        frames.reserve(min(num_frames, MAX_RESERVED_FRAMES));
+    }
+
+    bool touch(int page) { return page_table.isValid(page); }
+    bool isFull() const { return page_table.size() >= num_frames; }
+
+    // Reemplazar la página más antigua; su marco quedará para la nueva página
+    int evict() {
+        page_table.remove(frames[oldest]);
+        return frames[oldest];
+    }
+
+    void insert(int page) {
+        if (frames.size() < num_frames) {
+            page_table.insert(page, (int)frames.size());
+            frames.push_back(page);
+        } else {
+            page_table.insert(page, (int)oldest);
+            frames[oldest] = page;
+            oldest = (oldest + 1) % num_frames;
+        }
+    }
+
+    void save(CheckpointWriter& out) const {
+        out.putVector(frames);
+        out.put(oldest);
+        page_table.save(out);
+    }
+
+    void load(CheckpointReader& in) {
+        in.getVector(frames);
+        oldest = in.get<size_t>();
+        page_table.load(in);
+        if (frames.size() > num_frames || oldest >= max(num_frames, (size_t)1) ||
+            page_table.size() != frames.size()) {
+            failCorruptCheckpoint();
+        }
+        page_table.checkFrames(frames.size(), [this](int page, int frame) { return frames[frame] == page; });
+    }
+};
+
+// Algoritmo LRU
+// Los marcos forman una lista doblemente enlazada indexada por número de marco
+// (frente = más reciente, final = menos reciente) y la tabla de páginas da el marco de
+// cada página, así mover una página al frente o expulsar la última cuesta O(1).
+class LRUPolicy : public ReplacementPolicy<LRUPolicy> {
+private:
+    struct FrameNode {
+        int page_number;
+        int prev;   // Marco usado más recientemente que este (-1 si es el frente)
+        int next;   // Marco usado menos recientemente que este (-1 si es el final)
+    };
+
+    size_t num_frames;
+    vector<FrameNode> frames;   // Crece hasta num_frames a medida que se ocupan marcos
+    int head;                   // Marco más recientemente usado
+    int tail;                   // Marco menos recientemente usado
+    int free_frame;             // Marco liberado por evict() (-1 si no hay)
+    PageTable page_table;       // Página residente -> marco
+
+    void unlink(int frame) {
+        FrameNode& node = frames[frame];
+        (node.prev != -1 ? frames[node.prev].next : head) = node.next;
+        (node.next != -1 ? frames[node.next].prev : tail) = node.prev;
+    }
+
+    void pushFront(int frame) {
+        frames[frame].prev = -1;
+        frames[frame].next = head;
+        (head != -1 ? frames[head].prev : tail) = frame;
+        head = frame;
+    }
+
+public:
+    LRUPolicy(int frames_count)
+        : num_frames(frames_count), head(-1), tail(-1), free_frame(-1),
+          page_table(min(num_frames, MAX_RESERVED_FRAMES)) {
+        frames.reserve(min(num_frames, MAX_RESERVED_FRAMES));
+    }
+
+    bool touch(int page) {
+        int frame = page_table.frameOf(page);
+        if (frame == -1) {
+            return false;
+        }
+        // Mover la página al frente (más recientemente usada)
+        if (frame != head) {
+            unlink(frame);
+            pushFront(frame);
+        }
+        return true;
+    }
+
+    bool isFull() const { return page_table.size() >= num_frames; }
+
+    // Reemplazar la página menos recientemente usada (al final de la lista)
+    int evict() {
+        free_frame = tail;
+        page_table.remove(frames[tail].page_number);
+        unlink(tail);
+        return frames[free_frame].page_number;
+    }
+
+    void insert(int page) {
+        int frame = free_frame;
+        if (frame == -1) {
+            frame = (int)frames.size();
+            frames.push_back({page, -1, -1});
+        }
+        free_frame = -1;
+        frames[frame].page_number = page;
+        pushFront(frame);
+        page_table.insert(page, frame);
+    }
+
+    // free_frame solo vive entre evict() e insert(), así que no se guarda
+    void save(CheckpointWriter& out) const {
+        out.putVector(frames);
+        out.put(head);
+        out.put(tail);
+        page_table.save(out);
+    }
+
+    void load(CheckpointReader& in) {
+        in.getVector(frames);
+        head = in.get<int>();
+        tail = in.get<int>();
+        page_table.load(in);
+        if (frames.size() > num_frames || page_table.size() != frames.size()) {
+            failCorruptCheckpoint();
+        }
+        // Todos los marcos ocupados están en la lista, de head a tail
+        vector<bool> visited(frames.size(), false);
+        size_t length = 0;
+        if (checkLinkedList(frames, head, visited, length) != tail || length != frames.size()) {
+            failCorruptCheckpoint();
+        }
+        page_table.checkFrames(frames.size(),
+                               [this](int page, int frame) { return frames[frame].page_number == page; });
+    }
+};
+
+// Algoritmo Óptimo
+// Cada página residente se guarda en un conjunto ordenado por su próximo uso,
+// así la víctima (la que se usará más tarde) se obtiene en O(log m).
+class OptimalPolicy : public ReplacementPolicy<OptimalPolicy> {
+private:
+    size_t num_frames;
+    vector<size_t> next_use;               // Próximo uso de cada posición de la traza
+    size_t position;                       // Posición de la referencia actual
+    vector<size_t> frame_next_use;         // Marco -> posición del próximo uso de su página
+    int free_frame;                        // Marco liberado por evict() (-1 si no hay)
+    PageTable page_table;                  // Página residente -> marco
+    set<pair<size_t, int>> by_next_use;    // (próximo uso, página) ordenado de menor a mayor
+    struct ResidentPage {
+        int page_number;
+        int frame;
+    };
+    vector<ResidentPage> restored;         // Páginas residentes leídas de un punto de control
+
+public:
+    OptimalPolicy(int frames_count)
+        : num_frames(frames_count), position(0), free_frame(-1), page_table(min(num_frames, MAX_RESERVED_FRAMES)) {}
+
+    // position empieza en 0, o en la posición guardada si se reanuda desde un punto de
+    // control; en ese caso el próximo uso de las páginas residentes se busca desde ahí
+    void prepare(const vector<int>& references) {
+        next_use = computeNextUse(references);
+        if (restored.empty()) {
+            return;
+        }
+        PageTable pending(restored.size());
+        for (const ResidentPage& resident : restored) {
+            pending.insert(resident.page_number, resident.frame);
+            frame_next_use[resident.frame] = references.size();
+        }
+        for (size_t i = position; i < references.size() && pending.size() > 0; ++i) {
+            int frame = pending.frameOf(references[i]);
+            if (frame != -1) {
+                frame_next_use[frame] = i;
+                pending.remove(references[i]);
+            }
+        }
+        for (const ResidentPage& resident : restored) {
+            by_next_use.insert(make_pair(frame_next_use[resident.frame], resident.page_number));
+        }
+        restored.clear();
+    }
+
+    // Si la página ya está en los marcos solo se actualiza su próximo uso
+    bool touch(int page) {
+        size_t current = position++;
+        int frame = page_table.frameOf(page);
+        if (frame == -1) {
+            return false;
+        }
+        by_next_use.erase(make_pair(frame_next_use[frame], page));
+        frame_next_use[frame] = next_use[current];
+        by_next_use.insert(make_pair(next_use[current], page));
+        return true;
+    }
+
+    bool isFull() const { return page_table.size() >= num_frames; }
+
+    // Reemplazar la página que no se usará por más tiempo
+    int evict() {
+        auto victim = prev(by_next_use.end());
+        int page = victim->second;
+        free_frame = page_table.frameOf(page);
+        page_table.remove(page);
+        by_next_use.erase(victim);
+        return page;
+    }
+
+    void insert(int page) {
+        int frame = free_frame;
+        if (frame == -1) {
+            frame = (int)frame_next_use.size();
+            frame_next_use.push_back(0);
+        }
+        free_frame = -1;
+        frame_next_use[frame] = next_use[position - 1];
+        page_table.insert(page, frame);
+        by_next_use.insert(make_pair(next_use[position - 1], page));
+    }
+
+    // Los próximos usos dependen de la traza, así que solo se guardan las páginas
+    // residentes con su marco; prepare() los vuelve a calcular sobre la traza nueva
+    void save(CheckpointWriter& out) const {
+        vector<ResidentPage> resident;
+        for (const pair<size_t, int>& entry : by_next_use) {
+            resident.push_back({entry.second, page_table.frameOf(entry.second)});
+        }
+        out.put<uint64_t>(position);
+        out.put<uint64_t>(frame_next_use.size());
+        out.putVector(resident);
+    }
+
+    void load(CheckpointReader& in) {
+        position = in.get<uint64_t>();
+        uint64_t used_frames = in.get<uint64_t>();
+        if (used_frames > num_frames) {
+            failCorruptCheckpoint();
+        }
+        frame_next_use.assign(used_frames, 0);
+        in.getVector(restored);
+        if (restored.size() > frame_next_use.size()) {
+            failCorruptCheckpoint();
+        }
+        vector<bool> used(frame_next_use.size(), false);
+        for (const ResidentPage& resident : restored) {
+            if (resident.frame < 0 || (size_t)resident.frame >= frame_next_use.size() || used[resident.frame] ||
+                resident.page_number < 0 || page_table.isValid(resident.page_number)) {
+                failCorruptCheckpoint();
+            }
+            used[resident.frame] = true;
+            page_table.insert(resident.page_number, resident.frame);
+        }
+    }
+
+    bool resumableAt(uint64_t offset) const { return position == offset; }
+};
+
+// Estructura para el algoritmo Reloj (Clock)
+struct ClockEntry {
+    int page_number;
+    bool use_bit;
+};
+
+// Algoritmo LRU Reloj simple
+class ClockPolicy : public ReplacementPolicy<ClockPolicy> {
+private:
+    int num_frames;
+    int used_frames;
+    vector<ClockEntry> frames;
+    PageTable page_table;  // Página -> marco, para saber en O(1) si hay acierto
+    int hand;          // Apuntador del reloj
+
+public:
+    // Inicializar los marcos vacíos (-1 indica marco vacío)
+    ClockPolicy(int frames_count)
+        : num_frames(frames_count), used_frames(0), frames(frames_count, {-1, false}), page_table(frames_count), hand(0) {}
+
+    // Verificar si la página ya está en los marcos
+    bool touch(int page) {
+        int frame = page_table.frameOf(page);
+        if (frame == -1) {
+            return false;
+        }
+        frames[frame].use_bit = true;  // Marcar como usada
+        return true;
+    }
+
+    bool isFull() const { return used_frames == num_frames; }
+
+    // Avanzar el reloj dando una segunda oportunidad hasta encontrar un bit de uso en 0;
+    // el marco liberado queda bajo el apuntador
+    int evict() {
+        while (frames[hand].use_bit) {
+            frames[hand].use_bit = false;
+            hand = (hand + 1) % num_frames;
+        }
+        int page = frames[hand].page_number;
+        page_table.remove(page);
+        frames[hand].page_number = -1;
+        used_frames--;
+        return page;
+    }
+
+    // Mientras hay marcos libres el apuntador avanza por ellos en orden, así el marco
+    // bajo el apuntador siempre está libre al insertar
+    void insert(int page) {
+        frames[hand].page_number = page;
+        frames[hand].use_bit = true;
+        page_table.insert(page, hand);
+        hand = (hand + 1) % num_frames;
+        used_frames++;
+    }
+
+    void save(CheckpointWriter& out) const {
+        out.put(used_frames);
+        out.putVector(frames);
+        out.put(hand);
+        page_table.save(out);
+    }
+
+    void load(CheckpointReader& in) {
+        used_frames = in.get<int>();
+        in.getVector(frames);
+        hand = in.get<int>();
+        page_table.load(in);
+        if ((int)frames.size() != num_frames || hand < 0 || hand >= num_frames || used_frames < 0 ||
+            (size_t)used_frames != page_table.size()) {
+            failCorruptCheckpoint();
+        }
+        int occupied = 0;
+        for (const ClockEntry& entry : frames) {
+            checkBool(entry.use_bit);
+            occupied += entry.page_number != -1;
+        }
+        if (occupied != used_frames) {
+            failCorruptCheckpoint();
+        }
+        page_table.checkFrames(frames.size(),
+                               [this](int page, int frame) { return frames[frame].page_number == page; });
+    }
+};
+
+// Varias listas doblemente enlazadas de páginas que comparten un arreglo de nodos y una
+// PageTable página -> nodo (en el campo frame). Cada página está en a lo más una lista y
+// agregar, mover, quitar o sacar del final cuesta O(1). La usan ARC y 2Q, incluidas sus
+// listas "fantasma" de páginas que ya salieron de memoria.
+class PageLists {
+private:
+    struct Node {
+        int page_number;
+        int list;
+        int prev;   // Hacia el frente (más reciente); -1 si es el primero
+        int next;   // Hacia el final (menos reciente); -1 si es el último
+    };
+
+    struct List {
+        int head;
+        int tail;
+        size_t size;
+    };
+
+    vector<Node> nodes;
+    vector<int> free_nodes;
+    vector<List> lists;
+    PageTable index;
+
+    void unlink(int node) {
+        Node& n = nodes[node];
+        List& l = lists[n.list];
+        (n.prev != -1 ? nodes[n.prev].next : l.head) = n.next;
+        (n.next != -1 ? nodes[n.next].prev : l.tail) = n.prev;
+        l.size--;
+    }
+
+    void linkFront(int list, int node) {
+        List& l = lists[list];
+        nodes[node].list = list;
+        nodes[node].prev = -1;
+        nodes[node].next = l.head;
+        (l.head != -1 ? nodes[l.head].prev : l.tail) = node;
+        l.head = node;
+        l.size++;
+    }
+
+public:
+    PageLists(int num_lists, size_t expected_pages) : lists(num_lists, {-1, -1, 0}), index(expected_pages) {
+        nodes.reserve(expected_pages);
+    }
+
+    // Lista donde está la página, o -1 si no está en ninguna
+    int listOf(int page) const {
+        int node = index.frameOf(page);
+        return node == -1 ? -1 : nodes[node].list;
+    }
+
+    size_t size(int list) const { return lists[list].size; }
+
+    // Página menos reciente de la lista (la lista no debe estar vacía)
+    int back(int list) const { return nodes[lists[list].tail].page_number; }
+
+    // Agregar al frente una página que no está en ninguna lista
+    void pushFront(int list, int page) {
+        int node;
+        if (!free_nodes.empty()) {
+            node = free_nodes.back();
+            free_nodes.pop_back();
+        } else {
+            node = (int)nodes.size();
+            nodes.push_back({page, list, -1, -1});
+        }
+        nodes[node].page_number = page;
+        linkFront(list, node);
+        index.insert(page, node);
+    }
+
+    // Mover al frente de la lista indicada una página que ya está en alguna lista
+    void moveToFront(int list, int page) {
+        int node = index.frameOf(page);
+        unlink(node);
+        linkFront(list, node);
+    }
+
+    void remove(int page) {
+        int node = index.frameOf(page);
+        unlink(node);
+        index.remove(page);
+        free_nodes.push_back(node);
+    }
+
+    // Quitar y devolver la página menos reciente de la lista
+    int popBack(int list) {
+        int page = back(list);
+        remove(page);
+        return page;
+    }
+
+    void save(CheckpointWriter& out) const {
+        out.putVector(nodes);
+        out.putVector(free_nodes);
+        out.putVector(lists);
+        index.save(out);
+    }
+
+    void load(CheckpointReader& in) {
+        size_t num_lists = lists.size();
+        in.getVector(nodes);
+        in.getVector(free_nodes);
+        in.getVector(lists);
+        index.load(in);
+        if (lists.size() != num_lists) {
+            failCorruptCheckpoint();
+        }
+        // Cada nodo está en una sola lista (con su campo list correcto) o libre
+        vector<bool> visited(nodes.size(), false);
+        size_t listed = 0;
+        for (size_t l = 0; l < lists.size(); ++l) {
+            size_t length = 0;
+            if (checkLinkedList(nodes, lists[l].head, visited, length) != lists[l].tail || length != lists[l].size) {
+                failCorruptCheckpoint();
+            }
+            for (int node = lists[l].head; node != -1; node = nodes[node].next) {
+                if (nodes[node].list != (int)l) {
+                    failCorruptCheckpoint();
+                }
+            }
+            listed += length;
+        }
+        if (index.size() != listed) {
+            failCorruptCheckpoint();
+        }
+        index.checkFrames(nodes.size(), [this, &visited](int page, int node) {
+            return visited[node] && nodes[node].page_number == page;
+        });
+        checkFreeList(free_nodes, visited);
+        if (listed + free_nodes.size() != nodes.size()) {
+            failCorruptCheckpoint();
+        }
+    }
+};
+
+// ARC (Adaptive Replacement Cache, Megiddo y Modha). T1 tiene las páginas usadas una vez
+// y T2 las usadas más de una; B1 y B2 recuerdan las expulsadas de cada una. Un acierto en
+// B1 agranda el objetivo p de T1 y uno en B2 lo achica, así un recorrido secuencial largo
+// solo pasa por T1 sin desplazar las páginas reutilizadas de T2.
+class ARCPolicy : public ReplacementPolicy<ARCPolicy> {
+private:
+    enum { T1, T2, B1, B2 };
+
+    size_t c;               // Número de marcos
+    size_t p;               // Tamaño objetivo de T1
+    PageLists lists;
+    int ghost_list;         // Lista fantasma donde estaba la página que falló (-1 si ninguna)
+    bool drop_t1_lru;       // Caso IV.A con |T1| = c: se descarta el LRU de T1 sin recordarlo
+
+    size_t total() const { return lists.size(T1) + lists.size(T2) + lists.size(B1) + lists.size(B2); }
+
+public:
+    ARCPolicy(int frames_count)
+        : c(frames_count), p(0), lists(4, min(2 * c, MAX_RESERVED_FRAMES)), ghost_list(-1), drop_t1_lru(false) {}
+
+    bool touch(int page) {
+        int list = lists.listOf(page);
+        if (list == T1 || list == T2) {
+            lists.moveToFront(T2, page);  // Caso I: acierto
+            return true;
+        }
+        ghost_list = list;
+        drop_t1_lru = false;
+        if (list == B1) {
+            // Caso II: T1 debió ser más grande
+            p = min(c, p + max(lists.size(B2) / lists.size(B1), (size_t)1));
+        } else if (list == B2) {
+            // Caso III: T2 debió ser más grande
+            p -= min(p, max(lists.size(B1) / lists.size(B2), (size_t)1));
+        } else if (lists.size(T1) + lists.size(B1) == c) {
+            // Caso IV.A: L1 está completa
+            if (lists.size(T1) < c) {
+                lists.popBack(B1);
+            } else {
+                drop_t1_lru = true;
+            }
+        } else if (total() >= 2 * c) {
+            // Caso IV.B: el directorio completo tiene 2c páginas
+            lists.popBack(B2);
+        }
+        return false;
+    }
+
+    bool isFull() const { return lists.size(T1) + lists.size(T2) >= c; }
+
+    // REPLACE(x, p): expulsar el LRU de T1 o de T2 según el objetivo p
+    int evict() {
+        if (drop_t1_lru) {
+            return lists.popBack(T1);
+        }
+        size_t t1 = lists.size(T1);
+        if (t1 > 0 && (t1 > p || (ghost_list == B2 && t1 == p))) {
+            int page = lists.back(T1);
+            lists.moveToFront(B1, page);
+            return page;
+        }
+        int page = lists.back(T2);
+        lists.moveToFront(B2, page);
+        return page;
+    }
+
+    void insert(int page) {
+        if (ghost_list == B1 || ghost_list == B2) {
+            lists.moveToFront(T2, page);
+        } else {
+            lists.pushFront(T1, page);
+        }
+    }
+
+    // ghost_list y drop_t1_lru se recalculan en cada fallo, así que no se guardan
+    void save(CheckpointWriter& out) const {
+        out.put(p);
+        lists.save(out);
+    }
+
+    void load(CheckpointReader& in) {
+        p = in.get<size_t>();
+        lists.load(in);
+        if (p > c || lists.size(T1) + lists.size(T2) > c || total() > 2 * c) {
+            failCorruptCheckpoint();
+        }
+    }
+};
+
+// 2Q (Johnson y Shasha), versión completa. Las páginas nuevas entran a A1in (FIFO); si se
+// vuelven a usar después de salir de A1in (están en la lista fantasma A1out) pasan a Am (LRU).
+// Un recorrido secuencial solo circula por A1in y no desplaza las páginas de Am.
+class TwoQueuePolicy : public ReplacementPolicy<TwoQueuePolicy> {
+private:
+    enum { A1IN, A1OUT, AM };
+
+    size_t num_frames;
+    size_t k_in;            // Tamaño objetivo de A1in (25% de los marcos)
+    size_t k_out;           // Tamaño máximo de A1out (50% de los marcos)
+    PageLists lists;
+    bool ghost_hit;         // La página que falló estaba en A1out
+
+public:
+    TwoQueuePolicy(int frames_count)
+        : num_frames(frames_count), k_in(max(num_frames / 4, (size_t)1)), k_out(max(num_frames / 2, (size_t)1)),
+          lists(3, min(num_frames + k_out, MAX_RESERVED_FRAMES)), ghost_hit(false) {}
+
+    bool touch(int page) {
+        int list = lists.listOf(page);
+        if (list == AM) {
+            lists.moveToFront(AM, page);
+            return true;
+        }
+        if (list == A1IN) {
+            return true;  // En A1in un acierto no cambia el orden
+        }
+        ghost_hit = (list == A1OUT);
+        return false;
+    }
+
+    bool isFull() const { return lists.size(A1IN) + lists.size(AM) >= num_frames; }
+
+    // Liberar un marco: del final de A1in (recordándola en A1out) si A1in supera su objetivo,
+    // si no del final de Am
+    int evict() {
+        if (lists.size(A1IN) > k_in || lists.size(AM) == 0) {
+            int page = lists.back(A1IN);
+            lists.moveToFront(A1OUT, page);
+            if (lists.size(A1OUT) > k_out) {
+                lists.popBack(A1OUT);
+            }
+            return page;
+        }
+        return lists.popBack(AM);
+    }
+
+    void insert(int page) {
+        int list = lists.listOf(page);
+        if (ghost_hit) {
+            if (list == A1OUT) {
+                lists.moveToFront(AM, page);
+            } else {
+                lists.pushFront(AM, page);  // Salió de A1out al liberar el marco
+            }
+        } else {
+            lists.pushFront(A1IN, page);
+        }
+    }
+
+    void save(CheckpointWriter& out) const { lists.save(out); }
+    void load(CheckpointReader& in) {
+        lists.load(in);
+        if (lists.size(A1IN) + lists.size(AM) > num_frames || lists.size(A1OUT) > k_out) {
+            failCorruptCheckpoint();
+        }
+    }
+};
+
+// CLOCK-Pro (Jiang, Chen y Zhang). Todas las páginas están en un solo anillo con tres
+// manecillas: las residentes son calientes o frías y las frías expulsadas quedan un tiempo
+// como páginas de prueba sin marco. Si una página de prueba se vuelve a usar entra como
+// caliente y aumenta el espacio para frías (mem_cold); si su prueba vence, lo reduce.
+// Sigue la formulación simplificada habitual de CLOCK-Pro (hand_hot, hand_cold, hand_test).
+class ClockProPolicy : public ReplacementPolicy<ClockProPolicy> {
+private:
+    enum PageType { COLD, HOT, TEST };
+
+    struct Node {
+        int page_number;
+        PageType type;
+        bool ref;
+        int prev;
+        int next;
+    };
+
+    long long mem_max;       // Número de marcos
+    long long mem_cold;      // Objetivo de marcos para páginas frías
+    long long count_hot;
+    long long count_cold;
+    long long count_test;
+    int hand_hot;
+    int hand_cold;
+    int hand_test;
+    vector<Node> nodes;
+    vector<int> free_nodes;
+    PageTable index;         // Página -> nodo del anillo
+    bool promote;            // La página que falló estaba en prueba: entra como caliente
+    vector<int> evicted;     // Páginas expulsadas en la última llamada a evict()
+
+    // Insertar el nodo justo antes de hand_hot (la "cabeza" del anillo)
+    void metaAdd(int node) {
+        index.insert(nodes[node].page_number, node);
+        if (hand_hot == -1) {
+            nodes[node].prev = nodes[node].next = node;
+            hand_hot = hand_cold = hand_test = node;
+        } else {
+            int before = nodes[hand_hot].prev;
+            nodes[node].prev = before;
+            nodes[node].next = hand_hot;
+            nodes[before].next = node;
+            nodes[hand_hot].prev = node;
+        }
+        if (hand_cold == hand_hot) {
+            hand_cold = nodes[hand_cold].prev;
+        }
+    }
+
+    void metaDel(int node) {
+        index.remove(nodes[node].page_number);
+        if (nodes[node].next == node) {
+            hand_hot = hand_cold = hand_test = -1;
+        } else {
+            if (node == hand_hot) {
+                hand_hot = nodes[hand_hot].prev;
+            }
+            if (node == hand_cold) {
+                hand_cold = nodes[hand_cold].prev;
+            }
+            if (node == hand_test) {
+                hand_test = nodes[hand_test].prev;
+            }
+            nodes[nodes[node].prev].next = nodes[node].next;
+            nodes[nodes[node].next].prev = nodes[node].prev;
+        }
+        free_nodes.push_back(node);
+    }
+
+    int newNode(int page, PageType type) {
+        int node;
+        if (!free_nodes.empty()) {
+            node = free_nodes.back();
+            free_nodes.pop_back();
+        } else {
+            node = (int)nodes.size();
+            nodes.push_back(Node());
+        }
+        nodes[node] = {page, type, false, -1, -1};
+        return node;
+    }
+
+    void runHandCold() {
+        Node& n = nodes[hand_cold];
+        if (n.type == COLD) {
+            if (n.ref) {
+                n.type = HOT;  // Fría reutilizada: pasa a caliente
+                n.ref = false;
+                count_cold--;
+                count_hot++;
+            } else {
+                n.type = TEST;  // Expulsar, pero recordarla durante su prueba
+                count_cold--;
+                count_test++;
+                evicted.push_back(n.page_number);
+                while (mem_max < count_test) {
+                    runHandTest();
+                }
+            }
+        }
+        hand_cold = nodes[hand_cold].next;
+        while (mem_max - mem_cold < count_hot) {
+            runHandHot();
+        }
+    }
+
+    // Las manecillas no se adelantan entre sí; con un anillo de un solo nodo coinciden
+    // siempre y no hay nada que adelantar
+    bool singleNode() const { return nodes[hand_hot].next == hand_hot; }
+
+    void runHandHot() {
+        if (hand_hot == hand_test && !singleNode()) {
+            runHandTest();
+        }
+        Node& n = nodes[hand_hot];
+        if (n.type == HOT) {
+            if (n.ref) {
+                n.ref = false;
+            } else {
+                n.type = COLD;  // Caliente sin uso reciente: pasa a fría
+                count_hot--;
+                count_cold++;
+            }
+        }
+        hand_hot = nodes[hand_hot].next;
+    }
+
+    void runHandTest() {
+        if (hand_test == hand_cold && !singleNode()) {
+            runHandCold();
+        }
+        if (nodes[hand_test].type == TEST) {
+            // La prueba venció sin reutilización: olvidar la página
+            int prev_node = nodes[hand_test].prev;
+            metaDel(hand_test);
+            hand_test = prev_node;
+            count_test--;
+            if (mem_cold > 1) {
+                mem_cold--;
+            }
+        }
+        hand_test = nodes[hand_test].next;
+    }
+
+public:
+    ClockProPolicy(int frames_count)
+        : mem_max(frames_count), mem_cold(frames_count), count_hot(0), count_cold(0), count_test(0),
+          hand_hot(-1), hand_cold(-1), hand_test(-1), index(min((size_t)frames_count * 2, MAX_RESERVED_FRAMES)),
+          promote(false) {}
+
+    bool touch(int page) {
+        int node = index.frameOf(page);
+        promote = false;
+        if (node == -1) {
+            return false;
+        }
+        if (nodes[node].type != TEST) {
+            nodes[node].ref = true;
+            return true;
+        }
+        // Página en prueba: se saca del anillo y vuelve como caliente en insert()
+        promote = true;
+        if (mem_cold < mem_max) {
+            mem_cold++;
+        }
+        count_test--;
+        metaDel(node);
+        return false;
+    }
+
+    bool isFull() const { return count_hot + count_cold >= mem_max; }
+
+    int evict() {
+        evicted.clear();
+        while (evicted.empty()) {
+            runHandCold();
+        }
+        int page = evicted.back();
+        evicted.pop_back();
+        return page;
+    }
+
+    int extraEviction() {
+        if (evicted.empty()) {
+            return -1;
+        }
+        int page = evicted.back();
+        evicted.pop_back();
+        return page;
+    }
+
+    void insert(int page) {
+        metaAdd(newNode(page, promote ? HOT : COLD));
+        (promote ? count_hot : count_cold)++;
+    }
+
+    // promote y evicted solo valen durante un fallo, así que no se guardan
+    void save(CheckpointWriter& out) const {
+        out.put(mem_cold);
+        out.put(count_hot);
+        out.put(count_cold);
+        out.put(count_test);
+        out.put(hand_hot);
+        out.put(hand_cold);
+        out.put(hand_test);
+        out.putVector(nodes);
+        out.putVector(free_nodes);
+        index.save(out);
+    }
+
+    void load(CheckpointReader& in) {
+        mem_cold = in.get<long long>();
+        count_hot = in.get<long long>();
+        count_cold = in.get<long long>();
+        count_test = in.get<long long>();
+        hand_hot = in.get<int>();
+        hand_cold = in.get<int>();
+        hand_test = in.get<int>();
+        in.getVector(nodes);
+        in.getVector(free_nodes);
+        index.load(in);
+        if (mem_cold < 0 || mem_cold > mem_max || count_hot < 0 || count_cold < 0 || count_test < 0 ||
+            count_hot + count_cold > mem_max || count_test > mem_max) {
+            failCorruptCheckpoint();
+        }
+        checkIndex(hand_hot, nodes.size());
+        checkIndex(hand_cold, nodes.size());
+        checkIndex(hand_test, nodes.size());
+        // El anillo se recorre desde hand_hot; las otras manecillas deben estar en él y
+        // los contadores coincidir con los tipos de sus nodos
+        vector<bool> visited(nodes.size(), false);
+        long long counts[3] = {0, 0, 0};
+        size_t ring = 0;
+        if (hand_hot == -1) {
+            if (hand_cold != -1 || hand_test != -1) {
+                failCorruptCheckpoint();
+            }
+        } else {
+            int node = hand_hot;
+            do {
+                const Node& n = nodes[node];
+                checkIndex(n.next, nodes.size());
+                checkEnum(n.type, COLD, TEST);
+                checkBool(n.ref);
+                if (visited[node] || n.next == -1 || nodes[n.next].prev != node) {
+                    failCorruptCheckpoint();
+                }
+                visited[node] = true;
+                counts[n.type]++;
+                ring++;
+                node = n.next;
+            } while (node != hand_hot);
+            if (!visited[hand_cold] || !visited[hand_test]) {
+                failCorruptCheckpoint();
+            }
+        }
+        if (counts[COLD] != count_cold || counts[HOT] != count_hot || counts[TEST] != count_test ||
+            index.size() != ring) {
+            failCorruptCheckpoint();
+        }
+        index.checkFrames(nodes.size(), [this, &visited](int page, int node) {
+            return visited[node] && nodes[node].page_number == page;
+        });
+        checkFreeList(free_nodes, visited);
+        if (ring + free_nodes.size() != nodes.size()) {
+            failCorruptCheckpoint();
+        }
+    }
+};
+
+// LFU con envejecimiento. Las páginas se agrupan en cubetas por contador de usos, ordenadas
+// de menor a mayor; dentro de una cubeta se expulsa la menos reciente. Un acierto mueve la
+// página a la cubeta siguiente en O(1). Cada AGING_PERIOD_FACTOR * marcos referencias todos
+// los contadores se reducen a la mitad (redondeando hacia arriba) para olvidar la historia
+// vieja, recorriendo las cubetas una vez: costo amortizado O(1) por referencia.
+class LFUPolicy : public ReplacementPolicy<LFUPolicy> {
+private:
+    static const size_t AGING_PERIOD_FACTOR = 8;
+
+    struct Bucket {
+        long long count;
+        int head;   // Página más reciente de la cubeta (nodo)
+        int tail;   // Página menos reciente de la cubeta (nodo)
+        int prev;   // Cubeta con contador menor
+        int next;   // Cubeta con contador mayor
+    };
+
+    struct Node {
+        int page_number;
+        int bucket;
+        int prev;
+        int next;
+    };
+
+    size_t num_frames;
+    size_t aging_period;
+    size_t since_aging;
+    vector<Bucket> buckets;
+    vector<int> free_buckets;
+    int first_bucket;        // Cubeta con el menor contador
+    vector<Node> nodes;      // Un nodo por marco
+    int free_node;           // Nodo liberado por evict() (-1 si no hay)
+    PageTable page_table;    // Página residente -> nodo
+
+    int newBucket(long long count, int prev, int next) {
+        int b;
+        if (!free_buckets.empty()) {
+            b = free_buckets.back();
+            free_buckets.pop_back();
+        } else {
+            b = (int)buckets.size();
+            buckets.push_back(Bucket());
+        }
+        buckets[b] = {count, -1, -1, prev, next};
+        (prev != -1 ? buckets[prev].next : first_bucket) = b;
+        if (next != -1) {
+            buckets[next].prev = b;
+        }
+        return b;
+    }
+
+    void deleteBucket(int b) {
+        (buckets[b].prev != -1 ? buckets[buckets[b].prev].next : first_bucket) = buckets[b].next;
+        if (buckets[b].next != -1) {
+            buckets[buckets[b].next].prev = buckets[b].prev;
+        }
+        free_buckets.push_back(b);
+    }
+
+    void unlink(int node) {
+        Node& n = nodes[node];
+        Bucket& b = buckets[n.bucket];
+        (n.prev != -1 ? nodes[n.prev].next : b.head) = n.next;
+        (n.next != -1 ? nodes[n.next].prev : b.tail) = n.prev;
+    }
+
+    void linkFront(int b, int node) {
+        nodes[node].bucket = b;
+        nodes[node].prev = -1;
+        nodes[node].next = buckets[b].head;
+        (buckets[b].head != -1 ? nodes[buckets[b].head].prev : buckets[b].tail) = node;
+        buckets[b].head = node;
+    }
+
+    // Reducir todos los contadores a la mitad y unir las cubetas que queden iguales
+    void age() {
+        for (int b = first_bucket; b != -1;) {
+            buckets[b].count = (buckets[b].count + 1) / 2;
+            int prev = buckets[b].prev;
+            int next = buckets[b].next;
+            if (prev != -1 && buckets[prev].count == buckets[b].count) {
+                // Unir b con prev poniendo las páginas de b (que tenían más usos) al frente,
+                // es decir, más lejos de ser expulsadas
+                for (int node = buckets[b].head; node != -1; node = nodes[node].next) {
+                    nodes[node].bucket = prev;
+                }
+                nodes[buckets[b].tail].next = buckets[prev].head;
+                nodes[buckets[prev].head].prev = buckets[b].tail;
+                buckets[prev].head = buckets[b].head;
+                deleteBucket(b);
+            }
+            b = next;
+        }
+    }
+
+public:
+    LFUPolicy(int frames_count)
+        : num_frames(frames_count), aging_period(AGING_PERIOD_FACTOR * num_frames), since_aging(0),
+          first_bucket(-1), free_node(-1), page_table(min(num_frames, MAX_RESERVED_FRAMES)) {
+        nodes.reserve(min(num_frames, MAX_RESERVED_FRAMES));
+    }
+
+    bool touch(int page) {
+        if (++since_aging >= aging_period) {
+            since_aging = 0;
+            age();
+        }
+        int node = page_table.frameOf(page);
+        if (node == -1) {
+            return false;
+        }
+        // Pasar a la cubeta con contador + 1 (crearla si no existe)
+        int b = nodes[node].bucket;
+        long long count = buckets[b].count + 1;
+        int next = buckets[b].next;
+        if (next == -1 || buckets[next].count != count) {
+            next = newBucket(count, b, next);
+        }
+        unlink(node);
+        linkFront(next, node);
+        if (buckets[b].head == -1) {
+            deleteBucket(b);
+        }
+        return true;
+    }
+
+    bool isFull() const { return page_table.size() >= num_frames; }
+
+    // Expulsar la página menos reciente de la cubeta con menor contador
+    int evict() {
+        int b = first_bucket;
+        int node = buckets[b].tail;
+        int page = nodes[node].page_number;
+        unlink(node);
+        if (buckets[b].head == -1) {
+            deleteBucket(b);
+        }
+        page_table.remove(page);
+        free_node = node;
+        return page;
+    }
+
+    void insert(int page) {
+        int node = free_node;
+        if (node == -1) {
+            node = (int)nodes.size();
+            nodes.push_back(Node());
+        }
+        free_node = -1;
+        nodes[node].page_number = page;
+        if (first_bucket == -1 || buckets[first_bucket].count != 1) {
+            newBucket(1, -1, first_bucket);
+        }
+        linkFront(first_bucket, node);
+        page_table.insert(page, node);
+    }
+
+    void save(CheckpointWriter& out) const {
+        out.put(since_aging);
+        out.putVector(buckets);
+        out.putVector(free_buckets);
+        out.put(first_bucket);
+        out.putVector(nodes);
+        page_table.save(out);
+    }
+
+    void load(CheckpointReader& in) {
+        since_aging = in.get<size_t>();
+        in.getVector(buckets);
+        in.getVector(free_buckets);
+        first_bucket = in.get<int>();
+        in.getVector(nodes);
+        page_table.load(in);
+        if (nodes.size() > num_frames || since_aging >= aging_period || page_table.size() != nodes.size()) {
+            failCorruptCheckpoint();
+        }
+        // Las cubetas en uso forman una lista de contadores crecientes desde first_bucket,
+        // cada una con al menos una página; todos los nodos están en alguna cubeta
+        vector<bool> used_buckets(buckets.size(), false);
+        vector<bool> visited(nodes.size(), false);
+        size_t in_use = 0;
+        size_t listed = 0;
+        checkLinkedList(buckets, first_bucket, used_buckets, in_use);
+        for (int b = first_bucket; b != -1; b = buckets[b].next) {
+            const Bucket& bucket = buckets[b];
+            bool increasing = bucket.prev == -1 || buckets[bucket.prev].count < bucket.count;
+            if (bucket.head == -1 || bucket.count < 1 || !increasing ||
+                checkLinkedList(nodes, bucket.head, visited, listed) != bucket.tail) {
+                failCorruptCheckpoint();
+            }
+            for (int node = bucket.head; node != -1; node = nodes[node].next) {
+                if (nodes[node].bucket != b) {
+                    failCorruptCheckpoint();
+                }
+            }
+        }
+        checkFreeList(free_buckets, used_buckets);
+        if (in_use + free_buckets.size() != buckets.size() || listed != nodes.size()) {
+            failCorruptCheckpoint();
+        }
+        page_table.checkFrames(nodes.size(),
+                               [this](int page, int node) { return nodes[node].page_number == page; });
+    }
+};
+
+// Simula la traza completa con el algoritmo Policy y devuelve los fallos de página.
+// observer puede ser nullptr; en ese caso se usa el ciclo sin instrumentación.
+template <typename Policy>
+long long simulate(const vector<int>& references, int num_frames, ReferenceObserver* observer) {
+    Policy policy(num_frames);
+    return observer != nullptr ? policy.run(references, *observer) : policy.run(references);
+}
+
+// Simula la traza leída por bloques con el algoritmo Policy (modo flujo)
+template <typename Policy>
+long long simulateStream(TraceSource& source, int num_frames, size_t, ReferenceObserver* observer) {
+    Policy policy(num_frames);
+    return observer != nullptr ? policy.run(source, *observer) : policy.run(source);
+}
+
+// Opciones de los puntos de control (-punto, -cada, -reanudar)
+struct CheckpointOptions {
+    string algorithm;      // Nombre del algoritmo, se guarda en la cabecera
+    string resume_from;    // Punto de control desde el que se reanuda ("" = desde el inicio)
+    string save_to;        // Archivo donde se guarda el estado ("" = no se guarda)
+    size_t every;          // Guardar cada tantas referencias (0 = solo al terminar)
+    size_t resumed_at;     // Salida: posición de la traza donde se reanudó
+};
+
+// Cabecera del archivo de punto de control
+struct CheckpointHeader {
+    char magic[4];
+    uint32_t version;
+    char algorithm[16];    // Nombre del algoritmo (terminado en '\0')
+    int32_t num_frames;
+    uint64_t offset;       // Referencias de la traza ya simuladas
+    int64_t faults;        // Fallos acumulados hasta offset
+    uint64_t prefix_hash;  // Hash de las primeras offset referencias (hashReferences)
+};
+
+// Hash FNV-1a de 64 bits de las referencias [begin, end), continuando desde h. Se acumula
+// por tramos mientras se simula, así reanudar comprueba que la traza empiece con las mismas
+// referencias ya simuladas sin guardarlas en el punto de control.
+static const uint64_t REFERENCES_HASH_SEED = 0xCBF29CE484222325ULL;
+
+static uint64_t hashReferences(uint64_t h, const int* begin, const int* end) {
+    for (const int* p = begin; p != end; ++p) {
+        uint32_t value = (uint32_t)*p;
+        for (int byte = 0; byte < 4; ++byte) {
+            h ^= (value >> (8 * byte)) & 0xFF;
+            h *= 0x100000001B3ULL;
+        }
+    }
+    return h;
+}
+
+// Escribir la cabecera y el estado en un archivo temporal y renombrarlo, así una
+// interrupción a mitad de la escritura no pierde el punto de control anterior
+template <typename Policy>
+void writeCheckpoint(const Policy& policy, const CheckpointOptions& options, int num_frames, uint64_t offset,
+                     long long faults, uint64_t prefix_hash) {
+    string temporary = options.save_to + ".tmp";
+    CheckpointWriter out(temporary);
+    if (!out.isOpen()) {
+        cerr << "No se pudo escribir el punto de control " << options.save_to << endl;
+        exit(1);
+    }
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, 4);
+    header.version = CHECKPOINT_VERSION;
+    strncpy(header.algorithm, options.algorithm.c_str(), sizeof(header.algorithm) - 1);
+    header.num_frames = num_frames;
+    header.offset = offset;
+    header.faults = faults;
+    header.prefix_hash = prefix_hash;
+    out.put(header);
+    policy.save(out);
+    if (!out.close() || rename(temporary.c_str(), options.save_to.c_str()) != 0) {
+        cerr << "No se pudo escribir el punto de control " << options.save_to << endl;
+        exit(1);
+    }
+}
+
+// Simulación con puntos de control: opcionalmente recupera el estado guardado y sigue desde
+// su posición en la traza (que debe ser la misma traza, quizá con referencias agregadas al
+// final), y guarda el estado cada options.every referencias y al terminar. Devuelve los
+// fallos acumulados desde el comienzo de la traza. Con OPTIMO, reanudar sobre una traza que
+// creció no es exacto: las decisiones anteriores se tomaron sin ver las referencias nuevas.
+// Los barridos (-m A:B) no tienen punto de control: simulan todos los tamaños de una vez
+// con otro estado (pila de distancias o un algoritmo por tamaño) y main los rechaza.
+template <typename Policy>
+long long simulateCheckpointed(const vector<int>& references, int num_frames, CheckpointOptions& options,
+                               ReferenceObserver* observer) {
+    Policy policy(num_frames);
+    uint64_t offset = 0;
+    long long faults = 0;
+    uint64_t prefix_hash = REFERENCES_HASH_SEED;
+    if (!options.resume_from.empty()) {
+        CheckpointReader in(options.resume_from);
+        if (!in.isOpen()) {
+            cerr << "No se pudo abrir el punto de control " << options.resume_from << endl;
+            exit(1);
+        }
+        CheckpointHeader header = in.get<CheckpointHeader>();
+        if (memcmp(header.magic, CHECKPOINT_MAGIC, 4) != 0 || header.version != CHECKPOINT_VERSION) {
+            failCorruptCheckpoint();
+        }
+        header.algorithm[sizeof(header.algorithm) - 1] = '\0';
+        if (options.algorithm != header.algorithm || header.num_frames != num_frames) {
+            cerr << "El punto de control es de " << header.algorithm << " con " << header.num_frames
+                 << " marcos; use el mismo -a y -m para reanudar" << endl;
+            exit(1);
+        }
+        if (header.offset > references.size()) {
+            cerr << "La traza tiene " << references.size() << " referencias, menos que las " << header.offset
+                 << " ya simuladas en el punto de control" << endl;
+            exit(1);
+        }
+        offset = header.offset;
+        faults = header.faults;
+        prefix_hash = hashReferences(prefix_hash, references.data(), references.data() + offset);
+        if (prefix_hash != header.prefix_hash) {
+            cerr << "Las primeras " << offset << " referencias de la traza no son las del punto de control; "
+                 << "reanude sobre la misma traza (se pueden agregar referencias al final)" << endl;
+            exit(1);
+        }
+        policy.load(in);
+        if (!policy.resumableAt(offset)) {
+            failCorruptCheckpoint();
+        }
+    }
+    options.resumed_at = offset;
+
+    policy.prepare(references);
+    NullObserver none;
+    size_t step = options.every > 0 ? options.every : references.size();
+    while (offset < references.size()) {
+        size_t end = min(references.size(), (size_t)offset + step);
+        const int* begin = references.data() + offset;
+        faults += observer != nullptr ? policy.run(begin, references.data() + end, *observer)
+                                      : policy.run(begin, references.data() + end, none);
+        if (!options.save_to.empty()) {
+            prefix_hash = hashReferences(prefix_hash, begin, references.data() + end);
+        }
+        offset = end;
+        if (!options.save_to.empty() && offset < references.size()) {
+            writeCheckpoint(policy, options, num_frames, offset, faults, prefix_hash);
+        }
+    }
+    if (!options.save_to.empty()) {
+        writeCheckpoint(policy, options, num_frames, offset, faults, prefix_hash);
+    }
+    return faults;
+}
+
+// Óptimo aproximado con ventana de anticipación para el modo flujo.
+// Solo se conocen las próximas `window` referencias: una página residente que no aparece
+// en la ventana se considera "sin uso futuro". Con una ventana mayor o igual que la traza
+// el resultado es el mismo que OptimalPolicy; la memoria queda acotada por la ventana.
+class WindowedOptimalPolicy {
+private:
+    static const size_t NOT_IN_WINDOW = (size_t)-1;
+
+    size_t num_frames;
+    size_t window;
+    deque<int> pending;                          // Referencias leídas aún no simuladas
+    size_t next_position;                        // Posición (global) de la próxima referencia leída
+    unordered_map<int, deque<size_t>> upcoming;  // Página -> posiciones dentro de la ventana
+    unordered_map<int, size_t> frames;           // Página residente -> próximo uso conocido
+    set<pair<size_t, int>> by_next_use;          // (próximo uso, página) de las residentes
+    ReferenceObserver* observer;                 // Puede ser nullptr
+
+    void setNextUse(int page, size_t next_use) {
+        auto it = frames.find(page);
+        by_next_use.erase(make_pair(it->second, page));
+        it->second = next_use;
+        by_next_use.insert(make_pair(next_use, page));
+    }
+
+    // Simula la referencia más antigua de la ventana
+    bool step() {
+        int page = pending.front();
+        pending.pop_front();
+        deque<size_t>& positions = upcoming[page];
+        positions.pop_front();  // Es la posición actual
+        size_t next_use = positions.empty() ? NOT_IN_WINDOW : positions.front();
+        if (positions.empty()) {
+            upcoming.erase(page);
+        }
+
+        if (frames.count(page) != 0) {
+            setNextUse(page, next_use);
+            if (observer != nullptr) {
+                observer->onReference(page, false);
+            }
+            return false;
+        }
+        if (frames.size() >= num_frames) {
+            auto victim = prev(by_next_use.end());
+            int victim_page = victim->second;
+            frames.erase(victim_page);
+            by_next_use.erase(victim);
+            if (observer != nullptr) {
+                observer->onEvict(victim_page);
+            }
+        }
+        frames[page] = next_use;
+        by_next_use.insert(make_pair(next_use, page));
+        if (observer != nullptr) {
+            observer->onReference(page, true);
+        }
+        return true;
+    }
+
+public:
+    WindowedOptimalPolicy(int frames_count, size_t lookahead, ReferenceObserver* reference_observer = nullptr)
+        : num_frames(frames_count), window(max(lookahead, (size_t)1)), next_position(0),
+          observer(reference_observer) {}
+
+    // Agrega una referencia a la ventana; si la ventana se llena, simula la más antigua
+    bool access(int page) {
+        size_t position = next_position++;
+        pending.push_back(page);
+        deque<size_t>& positions = upcoming[page];
+        // Una residente sin uso conocido pasa a tener su próximo uso en esta posición
+        if (positions.empty() && frames.count(page) != 0) {
+            setNextUse(page, position);
+        }
+        positions.push_back(position);
+        return pending.size() > window ? step() : false;
+    }
+
+    // Simula las referencias que quedan en la ventana al terminar la traza
+    long long finish() {
+        long long page_faults = 0;
+        while (!pending.empty()) {
+            page_faults += step();
+        }
+        return page_faults;
+    }
+};
+
+// OPTIMO en modo flujo: usa la ventana de anticipación para aproximar el futuro
+long long simulateOptimalStream(TraceSource& source, int num_frames, size_t lookahead, ReferenceObserver* observer) {
+    WindowedOptimalPolicy policy(num_frames, lookahead, observer);
+    long long page_faults = 0;
+    vector<int> chunk;
+    while (source.next(chunk)) {
+        for (int page : chunk) {
+            page_faults += policy.access(page);
+        }
+    }
+    return page_faults + policy.finish();
+}
+
+// Tabla de páginas multinivel (radix) sobre números de página de 32 bits. Cada nivel
+// consume 32 / levels bits del número de página; los nodos se guardan contiguos en un
+// solo vector y se crean al mapear. Con páginas grandes la hoja está un nivel más arriba
+// y cada entrada cubre 2^bits_per_level páginas base.
+class RadixPageTable {
+private:
+    enum EntryState {
+        NO_CHILD = 0,        // Entrada sin nodo hijo / sin mapeo
+        LEAF_VALID = 1,
+        LEAF_INVALID = 2     // Mapeada alguna vez, pero no cargada
+    };
+
+    int levels;              // Niveles efectivos (uno menos con páginas grandes)
+    int bits_per_level;
+    uint32_t fanout_mask;
+    vector<int32_t> nodes;   // Nodo k ocupa [k * fanout, (k + 1) * fanout); el nodo 0 es la raíz
+
+    size_t indexAt(uint32_t key, int level) const {
+        return (key >> (bits_per_level * (levels - 1 - level))) & fanout_mask;
+    }
+
+public:
+    RadixPageTable(int total_levels, bool huge_pages)
+        : levels(huge_pages ? total_levels - 1 : total_levels), bits_per_level(32 / total_levels),
+          fanout_mask((1U << bits_per_level) - 1), nodes((size_t)1 << bits_per_level, NO_CHILD) {}
+
+    int hugePageShift() const { return bits_per_level; }
+
+    // Recorre la tabla para la clave (número de página ya desplazado si hay páginas grandes).
+    // Devuelve los accesos a memoria hechos; valid indica si terminó en una hoja válida.
+    int walk(uint32_t key, bool& valid) const {
+        size_t node = 0;
+        for (int level = 0; level < levels; ++level) {
+            int32_t entry = nodes[node + indexAt(key, level)];
+            if (level == levels - 1) {
+                valid = (entry == LEAF_VALID);
+                return level + 1;
+            }
+            if (entry == NO_CHILD) {
+                valid = false;
+                return level + 1;
+            }
+            node = (size_t)entry << bits_per_level;
+        }
+        valid = false;
+        return levels;
+    }
+
+    // Crear los nodos intermedios que falten y marcar la hoja como válida o no
+    void set(uint32_t key, bool valid) {
+        size_t node = 0;
+        for (int level = 0; level < levels - 1; ++level) {
+            int32_t& entry = nodes[node + indexAt(key, level)];
+            if (entry == NO_CHILD) {
+                entry = (int32_t)(nodes.size() >> bits_per_level);
+                nodes.resize(nodes.size() + ((size_t)1 << bits_per_level), NO_CHILD);
+                node = (size_t)nodes[node + indexAt(key, level)] << bits_per_level;  // nodes pudo moverse
+            } else {
+                node = (size_t)entry << bits_per_level;
+            }
+        }
+        nodes[node + indexAt(key, levels - 1)] = valid ? LEAF_VALID : LEAF_INVALID;
+    }
+};
+
+// TLB asociativa por conjuntos con su propia política de reemplazo dentro de cada conjunto
+class TLB {
+public:
+    enum Replacement { TLB_LRU, TLB_FIFO, TLB_RANDOM };
+
+private:
+    struct Entry {
+        uint32_t tag;
+        bool valid;
+        uint64_t stamp;   // Último uso (LRU) o momento de carga (FIFO)
+    };
+
+    size_t num_sets;
+    size_t ways;
+    Replacement replacement;
+    vector<Entry> entries;   // Conjunto s ocupa [s * ways, (s + 1) * ways)
+    uint64_t clock;
+    uint64_t random_state;
+
+    // El conjunto se elige con los bits bajos del número de página, como en hardware
+    Entry* setFor(uint32_t tag) {
+        return &entries[(tag % num_sets) * ways];
+    }
+
+public:
+    TLB(size_t total_entries, size_t associativity, Replacement policy)
+        : num_sets(max(total_entries / associativity, (size_t)1)), ways(associativity), replacement(policy),
+          entries(num_sets * ways, {0, false, 0}), clock(0), random_state(0x2545F4914F6CDD1DULL) {}
+
+    // Buscar una traducción; true si está en la TLB
+    bool lookup(uint32_t tag) {
+        Entry* set = setFor(tag);
+        clock++;
+        for (size_t w = 0; w < ways; ++w) {
+            if (set[w].valid && set[w].tag == tag) {
+                if (replacement == TLB_LRU) {
+                    set[w].stamp = clock;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Cargar una traducción después de recorrer la tabla de páginas
+    void fill(uint32_t tag) {
+        Entry* set = setFor(tag);
+        size_t victim = ways;
+        for (size_t w = 0; w < ways && victim == ways; ++w) {
+            if (!set[w].valid) {
+                victim = w;  // Usar primero una vía libre
+            }
+        }
+        if (victim == ways && replacement == TLB_RANDOM) {
+            random_state ^= random_state << 13;
+            random_state ^= random_state >> 7;
+            random_state ^= random_state << 17;
+            victim = random_state % ways;
+        } else if (victim == ways) {
+            // LRU y FIFO: la vía con la marca de tiempo más antigua
+            victim = 0;
+            for (size_t w = 1; w < ways; ++w) {
+                if (set[w].stamp < set[victim].stamp) {
+                    victim = w;
+                }
+            }
+        }
+        set[victim] = {tag, true, clock};
+    }
+
+    // Quitar una traducción (la página dejó de estar en memoria)
+    void invalidate(uint32_t tag) {
+        Entry* set = setFor(tag);
+        for (size_t w = 0; w < ways; ++w) {
+            if (set[w].valid && set[w].tag == tag) {
+                set[w].valid = false;
+            }
+        }
+    }
+};
+
+// Capa de traducción de direcciones: TLB + tabla de páginas (hash o radix de 2/4 niveles).
+// Observa la simulación: en cada referencia consulta la TLB y, si falla, recorre la tabla;
+// cuando el algoritmo expulsa una página invalida su entrada en la tabla y en la TLB.
+class TranslationModel : public ReferenceObserver {
+public:
+    static const int TLB_HIT_CYCLES = 1;         // Costo de una consulta a la TLB
+    static const int MEMORY_ACCESS_CYCLES = 100; // Costo de cada acceso a memoria en un recorrido
+    static const int HASHED_HUGE_PAGE_SHIFT = 9; // Página grande = 512 páginas base (tabla hash)
+
+private:
+    int levels;                 // 0 = tabla hash (PageTable), 2 o 4 = radix
+    bool huge_pages;
+    int huge_shift;             // Bits que se descartan del número de página con páginas grandes
+    PageTable hashed;
+    RadixPageTable radix;
+    TLB tlb;
+    PageTable resident_base_pages;  // Con páginas grandes: página grande -> páginas base residentes (en frame)
+
+    long long references;
+    long long tlb_hits;
+    long long walks;
+    long long walk_accesses;
+    int max_walk_depth;
+
+    uint32_t keyFor(int page) const {
+        return huge_pages ? ((uint32_t)page >> huge_shift) : (uint32_t)page;
+    }
+
+    // Recorre la tabla y devuelve los accesos hechos. Si la entrada no era válida (fallo de
+    // página) se vuelve a marcar válida, porque después de la referencia la página está en
+    // memoria.
+    int walk(uint32_t key) {
+        if (levels == 0) {
+            int depth = (int)hashed.probeCount((int)key);
+            if (!hashed.isValid((int)key)) {
+                hashed.insert((int)key);
+            }
+            return depth;
+        }
+        bool valid;
+        int depth = radix.walk(key, valid);
+        if (!valid) {
+            radix.set(key, true);
+        }
+        return depth;
+    }
+
+public:
+    TranslationModel(int table_levels, size_t tlb_entries, size_t tlb_ways, TLB::Replacement tlb_policy,
+                     bool huge)
+        : levels(table_levels), huge_pages(huge),
+          huge_shift(table_levels == 0 ? HASHED_HUGE_PAGE_SHIFT : 32 / max(table_levels, 1)),
+          radix(table_levels == 0 ? 4 : table_levels, huge && table_levels != 0), tlb(tlb_entries, tlb_ways, tlb_policy),
+          references(0), tlb_hits(0), walks(0), walk_accesses(0), max_walk_depth(0) {}
+
+    // Con páginas grandes, un fallo de una página base dentro de una página grande que ya
+    // tiene otras residentes no cambia la traducción: se consulta la TLB como en un acierto
+    void onReference(int page, bool fault) override {
+        references++;
+        uint32_t key = keyFor(page);
+        bool mapped = !fault;
+        if (huge_pages && fault) {
+            PageTableEntry* entry = resident_base_pages.find((int)key);
+            if (entry == nullptr) {
+                resident_base_pages.insert((int)key, 1);
+            } else {
+                mapped = true;
+                entry->frame++;
+            }
+        }
+        if (mapped && tlb.lookup(key)) {
+            tlb_hits++;
+            return;
+        }
+        int depth = walk(key);
+        walks++;
+        walk_accesses += depth;
+        max_walk_depth = max(max_walk_depth, depth);
+        tlb.fill(key);
+    }
+
+    // Con páginas grandes la traducción se quita solo cuando sale la última página base
+    void onEvict(int page) override {
+        uint32_t key = keyFor(page);
+        if (huge_pages) {
+            PageTableEntry* entry = resident_base_pages.find((int)key);
+            if (entry != nullptr && --entry->frame > 0) {
+                return;
+            }
+            resident_base_pages.remove((int)key);
+        }
+        tlb.invalidate(key);
+        if (levels == 0) {
+            hashed.invalidate((int)key);
+        } else {
+            radix.set(key, false);
+        }
+    }
+
+    void report(ostream& out) const {
+        long long cycles = references * TLB_HIT_CYCLES + walk_accesses * MEMORY_ACCESS_CYCLES;
+        out << "Aciertos de TLB: " << tlb_hits << " de " << references << " ("
+            << (references > 0 ? 100.0 * tlb_hits / references : 0.0) << "%)" << endl;
+        out << "Recorridos de la tabla de páginas: " << walks << ", profundidad promedio "
+            << (walks > 0 ? (double)walk_accesses / walks : 0.0) << ", máxima " << max_walk_depth << endl;
+        out << "Ciclos de traducción estimados: " << cycles << " ("
+            << (references > 0 ? (double)cycles / references : 0.0) << " por referencia)" << endl;
+    }
+};
+
+// Reparte cada referencia y expulsión entre varios observadores (traducción y estadísticas)
+class ObserverList : public ReferenceObserver {
+private:
+    vector<ReferenceObserver*> observers;
+
+public:
+    void add(ReferenceObserver* observer) { observers.push_back(observer); }
+    bool empty() const { return observers.empty(); }
+
+    // Devuelve un solo observador para la simulación: nullptr, el único o la lista
+    ReferenceObserver* get() {
+        if (observers.size() <= 1) {
+            return observers.empty() ? nullptr : observers[0];
+        }
+        return this;
+    }
+
+    void onReference(int page, bool fault) override {
+        for (ReferenceObserver* observer : observers) {
+            observer->onReference(page, fault);
+        }
+    }
+
+    void onEvict(int page) override {
+        for (ReferenceObserver* observer : observers) {
+            observer->onEvict(page);
+        }
+    }
+};
+
+// Estadísticas por ventanas de referencias, escritas a un archivo CSV o JSON a medida que
+// se completa cada ventana. Los contadores de fallos y expulsiones son exactos; el conjunto
+// de trabajo, los fallos fríos y el histograma de distancias de reuso se calculan sobre una
+// muestra de páginas (las que cumplen hash % sampling == 0) y se escalan por sampling, con
+// lo que el costo y la memoria bajan en esa proporción. Opcionalmente escribe también un
+// registro de eventos por referencia de las páginas muestreadas.
+class StatsObserver : public ReferenceObserver {
+public:
+    static const int REUSE_BUCKETS = 64;  // Cubetas log2 de la distancia de reuso
+
+private:
+    struct Window {
+        long long start;
+        long long references;
+        long long faults;
+        long long working_set;        // Páginas distintas (muestreadas) usadas en la ventana
+        long long cold_faults;        // Fallos de páginas (muestreadas) nunca vistas antes
+        long long evictions;
+        long long dead_evictions;     // Expulsadas sin haber tenido ningún acierto en memoria
+    };
+
+    long long window_size;
+    uint32_t sampling;
+    bool json;
+    ofstream out;
+    ofstream events;
+    vector<char> out_buffer;
+    vector<char> events_buffer;
+    string reuse_filename;            // Histograma aparte cuando la salida es CSV
+
+    Window current;
+    long long position;
+    bool first_window;                // Para las comas del arreglo JSON
+    unordered_map<int, long long> last_use;       // Página muestreada -> última posición
+    unordered_map<int, long long> hits_in_memory; // Página residente -> aciertos desde que se cargó
+    long long reuse_histogram[REUSE_BUCKETS];
+
+    bool sampled(int page) const { return PageTable::hashFunction(page) % sampling == 0; }
+
+    void resetWindow() {
+        current = {position, 0, 0, 0, 0, 0, 0};
+    }
+
+    void writeWindow() {
+        if (current.references == 0) {
+            return;
+        }
+        double fault_rate = (double)current.faults / current.references;
+        if (json) {
+            out << (first_window ? "\n" : ",\n") << "    {\"inicio\": " << current.start
+                << ", \"referencias\": " << current.references << ", \"fallos\": " << current.faults
+                << ", \"tasa_fallos\": " << fault_rate << ", \"conjunto_trabajo\": " << current.working_set * sampling
+                << ", \"fallos_frios\": " << current.cold_faults * sampling << ", \"expulsiones\": " << current.evictions
+                << ", \"expulsiones_sin_reuso\": " << current.dead_evictions << "}";
+        } else {
+            out << current.start << ',' << current.references << ',' << current.faults << ',' << fault_rate << ','
+                << current.working_set * sampling << ',' << current.cold_faults * sampling << ','
+                << current.evictions << ',' << current.dead_evictions << '\n';
+        }
+        first_window = false;
+    }
+
+public:
+    StatsObserver(const string& filename, long long window, uint32_t sample_one_in, const string& events_filename)
+        : window_size(max(window, 1LL)), sampling(max(sample_one_in, 1U)), out_buffer(1 << 20),
+          position(0), first_window(true) {
+        json = filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0;
+        out.rdbuf()->pubsetbuf(out_buffer.data(), out_buffer.size());
+        out.open(filename);
+        if (!out.is_open()) {
+            cerr << "No se pudo crear el archivo de estadísticas " << filename << endl;
+            exit(1);
+        }
+        if (json) {
+            out << "{\n  \"ventana\": " << window_size << ",\n  \"muestreo\": " << sampling << ",\n  \"ventanas\": [";
+        } else {
+            out << "inicio,referencias,fallos,tasa_fallos,conjunto_trabajo,fallos_frios,expulsiones,expulsiones_sin_reuso\n";
+            reuse_filename = filename + ".reuso.csv";
+        }
+        if (!events_filename.empty()) {
+            events_buffer.resize(1 << 20);
+            events.rdbuf()->pubsetbuf(events_buffer.data(), events_buffer.size());
+            events.open(events_filename);
+            if (!events.is_open()) {
+                cerr << "No se pudo crear el archivo de eventos " << events_filename << endl;
+                exit(1);
+            }
+            events << "posicion,pagina,evento\n";
+        }
+        for (long long& bucket : reuse_histogram) {
+            bucket = 0;
+        }
+        resetWindow();
+    }
+
+    void onReference(int page, bool fault) override {
+        current.references++;
+        current.faults += fault;
+        if (fault) {
+            hits_in_memory[page] = 0;
+        } else {
+            hits_in_memory[page]++;
+        }
+
+        if (sampled(page)) {
+            auto it = last_use.find(page);
+            if (it == last_use.end()) {
+                current.cold_faults++;
+                current.working_set++;
+                last_use[page] = position;
+            } else {
+                long long distance = position - it->second;
+                int bucket = 0;
+                while ((distance >> (bucket + 1)) != 0 && bucket + 1 < REUSE_BUCKETS) {
+                    bucket++;
+                }
+                reuse_histogram[bucket]++;
+                if (it->second < current.start) {
+                    current.working_set++;  // Primera vez que se usa en esta ventana
+                }
+                it->second = position;
+            }
+            if (events.is_open()) {
+                events << position << ',' << page << ',' << (fault ? "fallo" : "acierto") << '\n';
+            }
+        }
+
+        position++;
+        if (current.references == window_size) {
+            writeWindow();
+            resetWindow();
+        }
+    }
+
+    void onEvict(int page) override {
+        current.evictions++;
+        auto it = hits_in_memory.find(page);
+        if (it != hits_in_memory.end()) {
+            current.dead_evictions += (it->second == 0);
+            hits_in_memory.erase(it);
+        }
+        if (events.is_open() && sampled(page)) {
+            events << position << ',' << page << ",expulsion\n";
+        }
+    }
+
+    // Escribe la última ventana (incompleta) y el histograma de distancias de reuso
+    void finish() {
+        writeWindow();
+        resetWindow();
+        if (json) {
+            out << "\n  ],\n  \"distancias_reuso\": [";
+        } else {
+            out.close();
+            out.open(reuse_filename);
+            out << "distancia_desde,distancia_hasta,cantidad\n";
+        }
+        bool first = true;
+        for (int b = 0; b < REUSE_BUCKETS; ++b) {
+            if (reuse_histogram[b] == 0) {
+                continue;
+            }
+            long long from = 1LL << b;
+            long long to = (b + 1 < 63) ? (1LL << (b + 1)) - 1 : from;
+            if (json) {
+                out << (first ? "\n" : ",\n") << "    {\"desde\": " << from << ", \"hasta\": " << to
+                    << ", \"cantidad\": " << reuse_histogram[b] * sampling << "}";
+            } else {
+                out << from << ',' << to << ',' << reuse_histogram[b] * sampling << '\n';
+            }
+            first = false;
+        }
+        if (json) {
+            out << "\n  ]\n}\n";
+        }
+        out.close();
+        if (events.is_open()) {
+            events.close();
+        }
+    }
+};
+
+// Traza de varios procesos: cada referencia del archivo de texto se escribe "PID:PÁGINA"
+// (por ejemplo "0:12 1:7 0:13"). Los PID se renumeran en orden de aparición.
+struct ProcessTrace {
+    vector<int> pids;       // Índice de proceso -> PID original
+    vector<int> process;    // Referencia -> índice de proceso
+    vector<int> pages;      // Referencia -> página virtual del proceso
+};
+
+ProcessTrace readProcessTrace(const string& filename) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        cerr << "No se pudo abrir el archivo de referencias." << endl;
+        exit(1);
+    }
+    ProcessTrace trace;
+    unordered_map<int, int> index_of_pid;
+    size_t count = countReferences(file.begin(), file.end());
+    trace.process.reserve(count);
+    trace.pages.reserve(count);
+
+    const char* p = file.begin();
+    const char* end = file.end();
+    while (true) {
+        while (p != end && isSeparator(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            break;
+        }
+        const char* token = p;
+        uint64_t values[2] = {0, 0};
+        bool valid = true;
+        for (int field = 0; field < 2 && valid; ++field) {
+            const char* digits = p;
+            while (p != end && (unsigned)(*p - '0') < 10 && values[field] <= (uint64_t)INT32_MAX) {
+                values[field] = values[field] * 10 + (unsigned)(*p - '0');
+                ++p;
+            }
+            valid = p != digits && values[field] <= (uint64_t)INT32_MAX;
+            if (field == 0) {
+                valid = valid && p != end && *p == ':';
+                ++p;
+            }
+        }
+        if (!valid || (p != end && !isSeparator(*p))) {
+            cerr << "Referencia inválida en la posición " << (token - file.begin())
+                 << " del archivo (se espera PID:PÁGINA)." << endl;
+            exit(1);
+        }
+        auto it = index_of_pid.find((int)values[0]);
+        if (it == index_of_pid.end()) {
+            it = index_of_pid.insert(make_pair((int)values[0], (int)trace.pids.size())).first;
+            trace.pids.push_back((int)values[0]);
+        }
+        trace.process.push_back(it->second);
+        trace.pages.push_back((int)values[1]);
+    }
+    return trace;
+}
+
+// Observador de la simulación multiprogramada. Las páginas de todos los procesos se
+// renombran a claves globales (las que ve el algoritmo); cada proceso tiene su propia
+// PageTable página -> clave, cuyo bit de validez sigue la residencia de la página.
+// Lleva por proceso los fallos y los marcos que ocupa, y promedia esos marcos en cada
+// referencia del proceso.
+class MultiprogramObserver : public ReferenceObserver {
+private:
+    struct ProcessStats {
+        long long references;
+        long long faults;
+        long long resident;          // Marcos ocupados ahora
+        long long resident_sum;      // Suma de resident en cada referencia del proceso
+    };
+
+    vector<PageTable>& page_tables;
+    const vector<int>& owner;        // Clave -> índice de proceso
+    const vector<int>& virtual_page; // Clave -> página virtual
+    vector<ProcessStats> stats;
+
+public:
+    MultiprogramObserver(vector<PageTable>& tables, const vector<int>& key_owner, const vector<int>& key_page)
+        : page_tables(tables), owner(key_owner), virtual_page(key_page), stats(tables.size(), {0, 0, 0, 0}) {}
+
+    void onReference(int key, bool fault) override {
+        ProcessStats& process = stats[owner[key]];
+        process.references++;
+        if (fault) {
+            process.faults++;
+            process.resident++;
+            page_tables[owner[key]].insert(virtual_page[key], key);
+        }
+        process.resident_sum += process.resident;
+    }
+
+    void onEvict(int key) override {
+        stats[owner[key]].resident--;
+        page_tables[owner[key]].invalidate(virtual_page[key]);
+    }
+
+    void report(ostream& out, const vector<int>& pids) const {
+        out << "Proceso\tReferencias\tFallos\tTasa de fallos\tMarcos promedio" << endl;
+        long long total_references = 0;
+        long long total_faults = 0;
+        for (size_t i = 0; i < stats.size(); ++i) {
+            const ProcessStats& process = stats[i];
+            out << pids[i] << "\t" << process.references << "\t" << process.faults << "\t"
+                << (process.references > 0 ? (double)process.faults / process.references : 0.0) << "\t"
+                << (process.references > 0 ? (double)process.resident_sum / process.references : 0.0) << endl;
+            total_references += process.references;
+            total_faults += process.faults;
+        }
+        out << "Total\t" << total_references << "\t" << total_faults << "\t"
+            << (total_references > 0 ? (double)total_faults / total_references : 0.0) << endl;
+    }
 };
 
-// Clase para implementar la tabla de páginas como una tabla hash con chaining
-class PageTable {
+// Árbol de Fenwick (BIT) para contar cuántas posiciones marcadas hay en un prefijo
+class FenwickTree {
 private:
-    int table_size;    // Tamaño de la tabla hash
-    vector<list<PageTableEntry>> table;  // Vector de listas para implementar chaining
+    vector<int> tree;
 
 public:
-    // Constructor
-    PageTable(int size) : table_size(size), table(size) {}
+    FenwickTree(size_t size) : tree(size + 1, 0) {}
 
-    // Función hash simple
-    int hashFunction(int page_number) {
-        return page_number % table_size;
+    // Sumar delta en la posición pos (0-indexada)
+    void add(size_t pos, int delta) {
+        for (size_t i = pos + 1; i < tree.size(); i += i & (~i + 1)) {
+            tree[i] += delta;
+        }
     }
 
-    // Insertar una entrada en la tabla de páginas
-    void insert(int page_number) {
-        int index = hashFunction(page_number);
-        // Verificar si ya existe
-        for (auto& entry : table[index]) {
-            if (entry.page_number == page_number) {
-                entry.valid = true;
-                return;
+    // Suma de las posiciones [0, pos)
+    int prefix(size_t pos) const {
+        int sum = 0;
+        for (size_t i = pos; i > 0; i -= i & (~i + 1)) {
+            sum += tree[i];
+        }
+        return sum;
+    }
+};
+
+// Convierte el histograma de distancias de pila en fallos para cada tamaño 1..max_frames.
+// distances[d] cuenta los aciertos que requieren al menos d+1 marcos; misses son las
+// referencias que fallan con cualquier tamaño del rango (primera vez o distancia >= max_frames).
+vector<long long> faultsFromStackDistances(const vector<long long>& distances, long long misses) {
+    vector<long long> faults(distances.size() + 1, 0);
+    long long pending = misses;
+    for (size_t m = distances.size(); m >= 1; --m) {
+        faults[m] = pending;       // Con m marcos fallan las distancias >= m
+        pending += distances[m - 1];
+    }
+    return faults;  // faults[0] no se usa
+}
+
+// Barrido LRU en una sola pasada (algoritmo de pila de Mattson).
+// La distancia de pila de una referencia es el número de páginas distintas usadas desde
+// su uso anterior; se obtiene con un Fenwick que marca la última posición de cada página.
+vector<long long> sweepLRU(const vector<int>& references, int max_frames) {
+    vector<long long> distances(max_frames, 0);
+    long long misses = 0;
+    FenwickTree marks(references.size());
+    unordered_map<int, size_t> last_use;  // Página -> última posición en que se usó
+    last_use.reserve(references.size());
+
+    for (size_t i = 0; i < references.size(); ++i) {
+        auto it = last_use.find(references[i]);
+        if (it == last_use.end()) {
+            misses++;  // Fallo obligatorio para cualquier número de marcos
+            last_use[references[i]] = i;
+        } else {
+            // Páginas distintas usadas estrictamente entre el uso anterior y el actual
+            int distance = marks.prefix(i) - marks.prefix(it->second + 1);
+            if (distance < max_frames) {
+                distances[distance]++;
+            } else {
+                misses++;
             }
+            marks.add(it->second, -1);
+            it->second = i;
         }
-        // Si no existe, agregar nueva entrada
-        PageTableEntry new_entry = {page_number, true};
-        table[index].push_back(new_entry);
+        marks.add(i, 1);
     }
+    return faultsFromStackDistances(distances, misses);
+}
 
-    // Eliminar una entrada de la tabla de páginas
-    void remove(int page_number) {
-        int index = hashFunction(page_number);
-        table[index].remove_if([page_number](const PageTableEntry& entry) {
-            return entry.page_number == page_number;
-        });
+// Pila de prioridad del Óptimo como treap implícito: el orden en el árbol es el nivel de la
+// pila. Cada nodo guarda el próximo uso de su página y, para su subárbol, el menor y el mayor
+// próximo uso, los de sus extremos y si contiene dos niveles seguidos que no suben.
+class OptimalStack {
+private:
+    struct Node {
+        size_t value;        // Próximo uso de la página
+        uint32_t priority;
+        int left, right;
+        size_t size;
+        size_t min_value, max_value;
+        size_t first_value, last_value;
+        bool non_ascent;     // Algún par de niveles contiguos con value[l] >= value[l + 1]
+    };
+
+    vector<Node> nodes;
+    vector<int> free_nodes;
+    int root;
+    size_t capacity;
+    mt19937 rng;
+
+    size_t size(int t) const { return t < 0 ? 0 : nodes[t].size; }
+
+    void update(int t) {
+        Node& n = nodes[t];
+        n.size = 1;
+        n.min_value = n.max_value = n.first_value = n.last_value = n.value;
+        n.non_ascent = false;
+        if (n.left >= 0) {
+            const Node& l = nodes[n.left];
+            n.size += l.size;
+            n.min_value = min(n.min_value, l.min_value);
+            n.max_value = max(n.max_value, l.max_value);
+            n.first_value = l.first_value;
+            n.non_ascent = l.non_ascent || l.last_value >= n.value;
+        }
+        if (n.right >= 0) {
+            const Node& r = nodes[n.right];
+            n.size += r.size;
+            n.min_value = min(n.min_value, r.min_value);
+            n.max_value = max(n.max_value, r.max_value);
+            n.last_value = r.last_value;
+            n.non_ascent = n.non_ascent || r.non_ascent || n.value >= r.first_value;
+        }
     }
 
-    // Verificar si una página está en la tabla y es válida
-    bool isValid(int page_number) {
-        int index = hashFunction(page_number);
-        for (auto& entry : table[index]) {
-            if (entry.page_number == page_number && entry.valid) {
-                return true;
+    int merge(int a, int b) {
+        if (a < 0 || b < 0) {
+            return a < 0 ? b : a;
+        }
+        if (nodes[a].priority > nodes[b].priority) {
+            nodes[a].right = merge(nodes[a].right, b);
+            update(a);
+            return a;
+        }
+        nodes[b].left = merge(a, nodes[b].left);
+        update(b);
+        return b;
+    }
+
+    // Separa los primeros count niveles de t en a y el resto en b
+    void split(int t, size_t count, int& a, int& b) {
+        if (t < 0) {
+            a = b = -1;
+            return;
+        }
+        if (size(nodes[t].left) < count) {
+            split(nodes[t].right, count - size(nodes[t].left) - 1, nodes[t].right, b);
+            a = t;
+        } else {
+            split(nodes[t].left, count, a, nodes[t].left);
+            b = t;
+        }
+        update(t);
+    }
+
+    // Nivel del menor próximo uso de t
+    size_t positionOfMin(int t) const {
+        size_t offset = 0;
+        while (true) {
+            const Node& n = nodes[t];
+            if (n.left >= 0 && nodes[n.left].min_value == n.min_value) {
+                t = n.left;
+            } else if (n.value == n.min_value) {
+                return offset + size(n.left);
+            } else {
+                offset += size(n.left) + 1;
+                t = n.right;
             }
         }
-        return false;
     }
-};
 
-// Función para leer las referencias de página desde un archivo
-vector<int> readReferences(const string& filename) {
-    vector<int> references;
-    ifstream infile(filename);
-    if (!infile.is_open()) {
-        cerr << "No se pudo abrir el archivo de referencias." << endl;
-        exit(1);
+    // Primer nivel l >= 1 de t con value[l] <= value[l - 1]; t debe tener non_ascent
+    size_t firstNonAscent(int t) const {
+        size_t offset = 0;
+        while (true) {
+            const Node& n = nodes[t];
+            if (n.left >= 0 && nodes[n.left].non_ascent) {
+                t = n.left;
+                continue;
+            }
+            size_t left_size = size(n.left);
+            if (n.left >= 0 && nodes[n.left].last_value >= n.value) {
+                return offset + left_size;
+            }
+            if (n.right >= 0 && n.value >= nodes[n.right].first_value) {
+                return offset + left_size + 1;
+            }
+            offset += left_size + 1;
+            t = n.right;
+        }
     }
 
-    int page_number;
-    while (infile >> page_number) {
-        references.push_back(page_number);
+    // Primer nivel de t con próximo uso mayor que bound, o size(t) si no hay
+    size_t firstGreater(int t, size_t bound) const {
+        if (t < 0 || nodes[t].max_value <= bound) {
+            return size(t);
+        }
+        size_t offset = 0;
+        while (true) {
+            const Node& n = nodes[t];
+            if (n.left >= 0 && nodes[n.left].max_value > bound) {
+                t = n.left;
+            } else if (n.value > bound) {
+                return offset + size(n.left);
+            } else {
+                offset += size(n.left) + 1;
+                t = n.right;
+            }
+        }
     }
-    infile.close();
-    return references;
+
+    // Empuje de la pila sobre los niveles por encima de la página referenciada. Los récords
+    // (próximo uso mayor que todos los de arriba) bajan cada uno al lugar del siguiente y el
+    // resto no se mueve; visto así, cada récord salta por encima de los no récords que le
+    // siguen, y solo cambian de lugar los récords con un hueco detrás.
+    int pushRecordsDown(int todo) {
+        int done = -1;
+        while (todo >= 0 && nodes[todo].non_ascent) {
+            // Los niveles hasta q - 1 suben estrictamente: son récords seguidos
+            size_t q = firstNonAscent(todo);
+            int run, record, gap;
+            split(todo, q - 1, run, todo);
+            split(todo, 1, record, todo);
+            split(todo, firstGreater(todo, nodes[record].value), gap, todo);
+            done = merge(done, merge(run, merge(gap, record)));
+        }
+        return merge(done, todo);
+    }
+
+public:
+    OptimalStack(size_t capacity) : root(-1), capacity(capacity), rng(12345) {
+        nodes.reserve(min(capacity + 1, MAX_RESERVED_FRAMES));
+    }
+
+    // Referencia en el instante now a la página cuyo próximo uso es next. Devuelve el nivel en
+    // que estaba la página o capacity si no estaba en la pila. La página referenciada es la de
+    // menor próximo uso (justo now), así que se ubica sin guardar a qué página es cada nodo.
+    size_t reference(size_t now, size_t next) {
+        size_t depth = size(root);
+        bool hit = root >= 0 && nodes[root].min_value == now;
+        if (hit) {
+            depth = positionOfMin(root);
+        }
+        int above, referenced, below;
+        split(root, depth, above, below);
+        split(below, hit ? 1 : 0, referenced, below);
+        above = pushRecordsDown(above);
+
+        int top = referenced;
+        if (top < 0) {
+            if (!free_nodes.empty()) {
+                top = free_nodes.back();
+                free_nodes.pop_back();
+            } else {
+                nodes.push_back(Node());
+                top = (int)nodes.size() - 1;
+                nodes[top].priority = (uint32_t)rng();
+            }
+        }
+        nodes[top].value = next;
+        nodes[top].left = nodes[top].right = -1;
+        update(top);
+        root = merge(merge(top, above), below);
+
+        if (size(root) > capacity) {
+            // El último récord quedó fuera de los capacity niveles
+            int dropped;
+            split(root, capacity, root, dropped);
+            free_nodes.push_back(dropped);
+        }
+        return hit ? depth : capacity;
+    }
+};
+
+// Barrido Óptimo en una sola pasada usando su propiedad de pila: los primeros k niveles
+// de la pila son exactamente el contenido de memoria de OPT con k marcos. Al referenciar
+// una página se sube al tope y se "empuja" hacia abajo conservando en cada nivel la página
+// que se usará antes. La pila se limita a max_frames niveles y vive en un OptimalStack:
+// cada referencia cuesta O(log max_frames) más O(log max_frames) por récord que cambia de
+// lugar (en las trazas medidas, uno o dos por referencia).
+vector<long long> sweepOptimal(const vector<int>& references, int max_frames) {
+    vector<long long> distances(max_frames, 0);
+    long long misses = 0;
+    vector<size_t> next_use = computeNextUse(references);
+    OptimalStack stack(max_frames);
+
+    for (size_t i = 0; i < references.size(); ++i) {
+        size_t depth = stack.reference(i, next_use[i]);
+        if (depth < (size_t)max_frames) {
+            distances[depth]++;
+        } else {
+            misses++;
+        }
+    }
+    return faultsFromStackDistances(distances, misses);
 }
 
-// Función para simular el algoritmo Óptimo
-int simulateOptimal(const vector<int>& references, int num_frames) {
-    int page_faults = 0;
-    vector<int> frames;
+// Resultado de una simulación con asignación dinámica de marcos
+struct AllocationResult {
+    long long faults;
+    double average_frames;   // Marcos residentes promediados sobre todas las referencias
+    size_t peak_frames;
+};
+
+// Últimos usos de cada página para -ws y -pff: la PageTable asigna a cada página (en frame)
+// una casilla de un arreglo de posiciones de 64 bits, así las trazas de más de 2^31
+// referencias no desbordan; valid indica si la página está en memoria.
+class LastUseTable {
+private:
+    PageTable slots;
+    vector<uint64_t> positions;
+
+public:
+    // Entrada de la página, o nullptr si nunca se usó
+    PageTableEntry* find(int page) { return slots.find(page); }
+
+    uint64_t lastUse(const PageTableEntry* entry) const { return positions[entry->frame]; }
+    uint64_t lastUse(int page) { return positions[slots.find(page)->frame]; }
+
+    // Registrar el uso de la página en la posición i y marcarla residente
+    void touch(int page, uint64_t i) {
+        PageTableEntry* entry = slots.find(page);
+        if (entry == nullptr) {
+            entry = slots.insert(page, (int)positions.size());
+            positions.push_back(i);
+        } else {
+            entry->valid = true;
+            positions[entry->frame] = i;
+        }
+    }
+
+    void invalidate(int page) { slots.invalidate(page); }
+};
+
+// Conjunto de trabajo de Denning: una página está en memoria mientras se haya usado en
+// las últimas tau referencias, así que la asignación crece y se encoge con la localidad.
+template <typename Observer>
+AllocationResult simulateWorkingSet(const vector<int>& references, size_t tau, Observer& observer) {
+    LastUseTable last_use;
+    AllocationResult result = {0, 0.0, 0};
+    long long resident = 0;
+    double resident_sum = 0.0;
 
     for (size_t i = 0; i < references.size(); ++i) {
         int page = references[i];
-        // Si la página ya está en los marcos, no hay fallo
-        if (find(frames.begin(), frames.end(), page) != frames.end()) {
-            continue;
+        PageTableEntry* entry = last_use.find(page);
+        bool fault = entry == nullptr || !entry->valid;
+        last_use.touch(page, i);
+        if (fault) {
+            result.faults++;
+            resident++;
         }
+        observer.onReference(page, fault);
 
-        // Si hay espacio libre, agregar la página
-        if (frames.size() < num_frames) {
-            frames.push_back(page);
-        } else {
-            // Reemplazar la página que no se usará por más tiempo
-            int farthest = i;
-            int index_to_replace = -1;
-            for (int j = 0; j < frames.size(); ++j) {
-                int k;
-                for (k = i + 1; k < references.size(); ++k) {
-                    if (frames[j] == references[k]) {
-                        if (k > farthest) {
-                            farthest = k;
-                            index_to_replace = j;
-                        }
-                        break;
+        // La referencia i - tau sale de la ventana; su página se libera si no se volvió a usar
+        if (i >= tau) {
+            int old_page = references[i - tau];
+            PageTableEntry* old_entry = last_use.find(old_page);
+            if (old_entry->valid && last_use.lastUse(old_entry) == i - tau) {
+                old_entry->valid = false;
+                resident--;
+                observer.onEvict(old_page);
+            }
+        }
+        resident_sum += resident;
+        result.peak_frames = max(result.peak_frames, (size_t)resident);
+    }
+    result.average_frames = references.empty() ? 0.0 : resident_sum / references.size();
+    return result;
+}
+
+// Frecuencia de fallos de página (PFF) con dos umbrales sobre el intervalo entre fallos:
+// si el fallo llega antes de lower referencias el proceso necesita más memoria y se agrega
+// un marco; si llega después de upper se liberan las páginas no usadas desde el fallo
+// anterior; entre ambos la asignación se mantiene y se reemplaza una página con reloj.
+template <typename Observer>
+AllocationResult simulatePageFaultFrequency(const vector<int>& references, size_t lower, size_t upper,
+                                            Observer& observer) {
+    LastUseTable last_use;
+    vector<int> resident;        // Páginas en memoria, recorridas por la manecilla del reloj
+    size_t hand = 0;
+    size_t last_fault = 0;
+    AllocationResult result = {0, 0.0, 0};
+    double resident_sum = 0.0;
+
+    for (size_t i = 0; i < references.size(); ++i) {
+        int page = references[i];
+        PageTableEntry* entry = last_use.find(page);
+        bool fault = entry == nullptr || !entry->valid;
+        if (fault) {
+            size_t interval = i - last_fault;
+            if (interval > upper) {
+                // Pocos fallos: liberar lo que no se usó desde el fallo anterior
+                size_t kept = 0;
+                for (size_t r = 0; r < resident.size(); ++r) {
+                    PageTableEntry* candidate = last_use.find(resident[r]);
+                    if (last_use.lastUse(candidate) < last_fault) {
+                        candidate->valid = false;
+                        observer.onEvict(resident[r]);
+                    } else {
+                        resident[kept++] = resident[r];
                     }
                 }
-                // Si la página no se usará de nuevo
-                if (k == references.size()) {
-                    index_to_replace = j;
-                    break;
+                resident.resize(kept);
+                hand = 0;
+            } else if (interval >= lower && !resident.empty()) {
+                // Frecuencia aceptable: reemplazar sin cambiar la asignación. La manecilla
+                // salta las páginas usadas desde el último fallo, a lo sumo una vuelta.
+                size_t victim = hand % resident.size();
+                for (size_t step = 0; step < resident.size(); ++step) {
+                    size_t slot = (hand + step) % resident.size();
+                    if (last_use.lastUse(resident[slot]) < last_fault) {
+                        victim = slot;
+                        break;
+                    }
                 }
+                last_use.invalidate(resident[victim]);
+                observer.onEvict(resident[victim]);
+                resident[victim] = resident.back();
+                resident.pop_back();
+                hand = victim;
             }
-            if (index_to_replace == -1) {
-                index_to_replace = 0;
-            }
-            frames[index_to_replace] = page;
+            resident.push_back(page);
+            last_fault = i;
+            result.faults++;
         }
-        page_faults++;
+        last_use.touch(page, i);
+        observer.onReference(page, fault);
+        resident_sum += resident.size();
+        result.peak_frames = max(result.peak_frames, resident.size());
     }
-    return page_faults;
+    result.average_frames = references.empty() ? 0.0 : resident_sum / references.size();
+    return result;
+}
+
+// Elige la asignación dinámica pedida (-ws o -pff); sin observador se usa NullObserver
+template <typename Observer>
+AllocationResult simulateAllocation(const vector<int>& references, size_t tau, size_t lower, size_t upper,
+                                    Observer& observer) {
+    return tau > 0 ? simulateWorkingSet(references, tau, observer)
+                   : simulatePageFaultFrequency(references, lower, upper, observer);
 }
 
-// Función para simular el algoritmo FIFO
-int simulateFIFO(const vector<int>& references, int num_frames) {
-    int page_faults = 0;
-    queue<int> frames;
-    std::unordered_set<int> pages_in_memory;  // Usar std::unordered_set
+// Algoritmos disponibles para -a. Para agregar uno basta con escribir su clase sobre
+// ReplacementPolicy y registrarla aquí; sweep es nullptr si no es un algoritmo de pila.
+struct AlgorithmInfo {
+    const char* name;
+    const char* alias;
+    long long (*simulate)(const vector<int>& references, int num_frames, ReferenceObserver* observer);
+    long long (*simulate_stream)(TraceSource& source, int num_frames, size_t lookahead, ReferenceObserver* observer);
+    vector<long long> (*sweep)(const vector<int>& references, int max_frames);
+    long long (*simulate_checkpointed)(const vector<int>& references, int num_frames, CheckpointOptions& options,
+                                       ReferenceObserver* observer);
+};
+
+static const AlgorithmInfo ALGORITHMS[] = {
+    {"FIFO", "FIFO", simulate<FIFOPolicy>, simulateStream<FIFOPolicy>, nullptr,
+     simulateCheckpointed<FIFOPolicy>},
+    {"LRU", "LRU", simulate<LRUPolicy>, simulateStream<LRUPolicy>, sweepLRU,
+     simulateCheckpointed<LRUPolicy>},
+    {"OPTIMO", "OPT", simulate<OptimalPolicy>, simulateOptimalStream, sweepOptimal,
+     simulateCheckpointed<OptimalPolicy>},
+    {"RELOJ", "CLOCK", simulate<ClockPolicy>, simulateStream<ClockPolicy>, nullptr,
+     simulateCheckpointed<ClockPolicy>},
+    {"ARC", "ARC", simulate<ARCPolicy>, simulateStream<ARCPolicy>, nullptr,
+     simulateCheckpointed<ARCPolicy>},
+    {"2Q", "2Q", simulate<TwoQueuePolicy>, simulateStream<TwoQueuePolicy>, nullptr,
+     simulateCheckpointed<TwoQueuePolicy>},
+    {"CLOCKPRO", "CLOCK-PRO", simulate<ClockProPolicy>, simulateStream<ClockProPolicy>, nullptr,
+     simulateCheckpointed<ClockProPolicy>},
+    {"LFU", "LFU", simulate<LFUPolicy>, simulateStream<LFUPolicy>, nullptr,
+     simulateCheckpointed<LFUPolicy>},
+};
 
-    for (int page : references) {
-        // Si la página ya está en los marcos, no hay fallo
-        if (pages_in_memory.find(page) != pages_in_memory.end()) {
-            continue;
+// Busca un algoritmo por nombre o alias; nullptr si no existe
+const AlgorithmInfo* findAlgorithm(const string& name) {
+    for (const AlgorithmInfo& info : ALGORITHMS) {
+        if (name == info.name || name == info.alias) {
+            return &info;
         }
+    }
+    return nullptr;
+}
 
-        // Si hay espacio libre, agregar la página
-        if (frames.size() < num_frames) {
-            frames.push(page);
-            pages_in_memory.insert(page);
-        } else {
-            // Reemplazar la página más antigua
-            int page_to_remove = frames.front();
-            frames.pop();
-            pages_in_memory.erase(page_to_remove);
+// Interpreta el valor de -a: un nombre, una lista separada por comas o ALL (todos)
+bool parseAlgorithmList(const string& text, vector<const AlgorithmInfo*>& selected) {
+    selected.clear();
+    if (text == "ALL") {
+        for (const AlgorithmInfo& info : ALGORITHMS) {
+            selected.push_back(&info);
+        }
+        return true;
+    }
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == string::npos) {
+            comma = text.size();
+        }
+        const AlgorithmInfo* info = findAlgorithm(text.substr(start, comma - start));
+        if (info == nullptr) {
+            cerr << "Algoritmo desconocido: " << text.substr(start, comma - start) << endl;
+            return false;
+        }
+        selected.push_back(info);
+        start = comma + 1;
+    }
+    return true;
+}
 
-            frames.push(page);
-            pages_in_memory.insert(page);
+// Ejecuta varios algoritmos en paralelo sobre la misma traza (de solo lectura).
+// Cada hilo del grupo toma el siguiente algoritmo pendiente hasta que no quede ninguno.
+vector<long long> simulateParallel(const vector<int>& references, int num_frames,
+                                   const vector<const AlgorithmInfo*>& selected) {
+    vector<long long> faults(selected.size(), 0);
+    atomic<size_t> next_task(0);
+    auto worker = [&]() {
+        for (size_t task = next_task++; task < selected.size(); task = next_task++) {
+            faults[task] = selected[task]->simulate(references, num_frames, nullptr);
         }
-        page_faults++;
+    };
+
+    size_t num_threads = min((size_t)max(thread::hardware_concurrency(), 1u), selected.size());
+    vector<thread> pool;
+    for (size_t i = 1; i < num_threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();  // El hilo principal también trabaja
+    for (auto& t : pool) {
+        t.join();
+    }
+    return faults;
+}
+
+// Ejecuta body(t) para t = 0 .. num_threads - 1, cada uno en su hilo (el 0 en el actual)
+template <typename Body>
+void runOnThreads(size_t num_threads, Body body) {
+    vector<thread> pool;
+    for (size_t t = 1; t < num_threads; ++t) {
+        pool.emplace_back(body, t);
+    }
+    body(0);  // El hilo principal también trabaja
+    for (auto& worker : pool) {
+        worker.join();
     }
-    return page_faults;
 }
 
-// Función para simular el algoritmo LRU
-int simulateLRU(const vector<int>& references, int num_frames) {
-    int page_faults = 0;
-    list<int> frames;
-    std::unordered_set<int> pages_in_memory;  // Usar std::unordered_set
+// Simulación asociativa por conjuntos (-conjuntos): los num_frames marcos se dividen en
+// num_sets conjuntos de num_frames / num_sets vías y cada página va siempre al conjunto
+// hash(página) % num_sets, como en una caché. Los conjuntos no comparten marcos, así que la
+// traza se reparte en una subsecuencia por conjunto y cada una se simula por separado en
+// paralelo; los fallos totales son la suma. Con un solo conjunto es la simulación exacta
+// totalmente asociativa, en serie. Devuelve los fallos de cada algoritmo de selected.
+vector<long long> simulateSetAssociative(const vector<int>& references, int num_frames, int num_sets,
+                                         const vector<const AlgorithmInfo*>& selected, size_t num_threads) {
+    size_t sets = (size_t)num_sets;
+    num_threads = max(num_threads, (size_t)1);
 
-    for (int page : references) {
-        // Si la página ya está en los marcos
-        if (pages_in_memory.find(page) != pages_in_memory.end()) {
-            // Mover la página al frente (más recientemente usada)
-            frames.remove(page);
-            frames.push_front(page);
-            continue;
+    // Repartir la traza por conjuntos en paralelo: cada hilo cuenta cuántas referencias de su
+    // tramo van a cada conjunto y luego las copia a partir de su desplazamiento en el conjunto
+    vector<vector<int>> shards(sets);
+    if (sets > 1) {
+        size_t chunk = (references.size() + num_threads - 1) / num_threads;
+        vector<vector<size_t>> counts(num_threads, vector<size_t>(sets, 0));
+        auto setOf = [sets](int page) { return PageTable::hashFunction(page) % sets; };
+        runOnThreads(num_threads, [&](size_t t) {
+            size_t end = min(references.size(), (t + 1) * chunk);
+            for (size_t i = t * chunk; i < end; ++i) {
+                counts[t][setOf(references[i])]++;
+            }
+        });
+        for (size_t set = 0; set < sets; ++set) {
+            size_t offset = 0;
+            for (size_t t = 0; t < num_threads; ++t) {
+                size_t count = counts[t][set];
+                counts[t][set] = offset;  // Desde aquí escribe el hilo t en este conjunto
+                offset += count;
+            }
+            shards[set].resize(offset);
         }
+        runOnThreads(num_threads, [&](size_t t) {
+            size_t end = min(references.size(), (t + 1) * chunk);
+            vector<size_t>& next = counts[t];
+            for (size_t i = t * chunk; i < end; ++i) {
+                size_t set = setOf(references[i]);
+                shards[set][next[set]++] = references[i];
+            }
+        });
+    }
 
-        // Si hay espacio libre
-        if (frames.size() < num_frames) {
-            frames.push_front(page);
-            pages_in_memory.insert(page);
-        } else {
-            // Reemplazar la página menos recientemente usada (al final de la lista)
-            int lru_page = frames.back();
-            frames.pop_back();
-            pages_in_memory.erase(lru_page);
+    // Simular cada par (algoritmo, conjunto) como una tarea independiente
+    int ways = num_frames / num_sets;
+    vector<vector<long long>> faults(selected.size(), vector<long long>(sets, 0));
+    atomic<size_t> next_task(0);
+    size_t tasks = selected.size() * sets;
+    runOnThreads(num_threads, [&](size_t) {
+        for (size_t task = next_task++; task < tasks; task = next_task++) {
+            size_t algorithm = task / sets;
+            size_t set = task % sets;
+            const vector<int>& shard = sets == 1 ? references : shards[set];  // Un conjunto: la traza tal cual
+            faults[algorithm][set] = selected[algorithm]->simulate(shard, ways, nullptr);
+        }
+    });
 
-            frames.push_front(page);
-            pages_in_memory.insert(page);
+    vector<long long> totals(selected.size(), 0);
+    for (size_t a = 0; a < selected.size(); ++a) {
+        for (long long set_faults : faults[a]) {
+            totals[a] += set_faults;
         }
-        page_faults++;
     }
-    return page_faults;
+    size_t largest = sets == 1 ? references.size() : 0;
+    for (const vector<int>& shard : shards) {
+        largest = max(largest, shard.size());
+    }
+    cout << "Conjuntos: " << sets << " de " << ways << " marcos, " << num_threads << " hilos, conjunto mayor: "
+         << largest << " referencias (promedio " << references.size() / sets << ")" << endl;
+    return totals;
 }
 
-// Estructura para el algoritmo Reloj (Clock)
-struct ClockEntry {
-    int page_number;
-    bool use_bit;
-};
+// Interpreta el valor de -m: un número "N" o un rango "A:B" / "A:B:PASO" para el modo barrido
+bool parseFrameRange(const string& text, int& first, int& last, int& step, bool& sweep) {
+    first = last = step = 0;
+    sweep = false;
+    size_t colon = text.find(':');
+    if (colon == string::npos) {
+        first = last = atoi(text.c_str());
+        step = 1;
+    } else {
+        sweep = true;
+        size_t second_colon = text.find(':', colon + 1);
+        first = atoi(text.substr(0, colon).c_str());
+        last = atoi(text.substr(colon + 1, second_colon - colon - 1).c_str());
+        step = (second_colon == string::npos) ? 1 : atoi(text.substr(second_colon + 1).c_str());
+    }
+    return first > 0 && last >= first && step > 0;
+}
 
-// Función para simular el algoritmo LRU Reloj simple
-int simulateClock(const vector<int>& references, int num_frames) {
-    int page_faults = 0;
-    vector<ClockEntry> frames;
-    int hand = 0;  // Apuntador del reloj
+// Simula varios procesos que comparten num_frames marcos.
+// Reemplazo global: un solo algoritmo elige víctimas entre las páginas de todos los procesos.
+// Reemplazo local: los marcos se reparten en partes iguales y cada proceso reemplaza solo
+// dentro de su parte, así que cada uno se simula por separado con su subsecuencia.
+int simulateMultiprogram(const AlgorithmInfo& algorithm, const ProcessTrace& trace, int num_frames, bool global) {
+    size_t num_processes = trace.pids.size();
+    if (!global && (size_t)num_frames < num_processes) {
+        cerr << "El reemplazo local necesita al menos un marco por proceso (" << num_processes << " procesos)" << endl;
+        return 1;
+    }
 
-    // Inicializar los marcos vacíos
-    for (int i = 0; i < num_frames; ++i) {
-        frames.push_back({-1, false});  // -1 indica marco vacío
+    // Renombrar (proceso, página) a claves globales densas, con una tabla por proceso
+    vector<PageTable> page_tables(num_processes);
+    vector<int> owner;
+    vector<int> virtual_page;
+    vector<int> keys(trace.pages.size());
+    for (size_t i = 0; i < trace.pages.size(); ++i) {
+        PageTable& table = page_tables[trace.process[i]];
+        PageTableEntry* entry = table.find(trace.pages[i]);
+        if (entry == nullptr) {
+            entry = table.insert(trace.pages[i], (int)owner.size());
+            entry->valid = false;  // Aún no está en memoria
+            owner.push_back(trace.process[i]);
+            virtual_page.push_back(trace.pages[i]);
+        }
+        keys[i] = entry->frame;
     }
 
-    for (int page : references) {
-        bool page_in_memory = false;
-        // Verificar si la página ya está en los marcos
-        for (auto& entry : frames) {
-            if (entry.page_number == page) {
-                entry.use_bit = true;  // Marcar como usada
-                page_in_memory = true;
-                break;
-            }
+    MultiprogramObserver observer(page_tables, owner, virtual_page);
+    if (global) {
+        algorithm.simulate(keys, num_frames, &observer);
+    } else {
+        vector<vector<int>> per_process(num_processes);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            per_process[trace.process[i]].push_back(keys[i]);
         }
-        if (page_in_memory) {
-            continue;  // No hay fallo de página
+        for (size_t p = 0; p < num_processes; ++p) {
+            int frames = num_frames / (int)num_processes + ((int)p < num_frames % (int)num_processes ? 1 : 0);
+            algorithm.simulate(per_process[p], frames, &observer);
         }
+    }
 
-        // Reemplazar páginas usando el algoritmo del reloj
-        while (true) {
-            if (frames[hand].use_bit == false) {
-                // Reemplazar esta página
-                frames[hand].page_number = page;
-                frames[hand].use_bit = true;
-                hand = (hand + 1) % num_frames;
-                break;
-            } else {
-                // Dar una segunda oportunidad
-                frames[hand].use_bit = false;
-                hand = (hand + 1) % num_frames;
-            }
+    cout << "Reemplazo " << (global ? "global" : "local") << " con " << num_frames << " marcos ("
+         << algorithm.name << ", " << num_processes << " procesos)" << endl;
+    observer.report(cout, trace.pids);
+    return 0;
+}
+
+// Microbenchmark de los algoritmos: mide referencias por segundo del ciclo de simulación
+// (sin observadores) sobre cada patrón sintético, con 4 * num_frames páginas distintas.
+int runBenchmark(const vector<const AlgorithmInfo*>& algorithms, int num_frames, size_t length) {
+    static const char* const MODELS[] = {"uniforme", "zipf", "ciclo", "recorrido"};
+    long long pages = min((long long)num_frames * 4, (long long)INT32_MAX);
+
+    cout << "Traza\tAlgoritmo\tReferencias/s\tFallos" << endl;
+    for (const char* model : MODELS) {
+        SyntheticSpec spec;
+        parseSyntheticSpec(string(model) + ":" + to_string(length) + ":" + to_string(pages), 12345, spec);
+        SyntheticTraceSource source(spec);
+        vector<int> references = readAllReferences(source);
+        for (const AlgorithmInfo* algorithm : algorithms) {
+            auto start = chrono::steady_clock::now();
+            long long faults = algorithm->simulate(references, num_frames, nullptr);
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << model << "\t" << algorithm->name << "\t"
+                 << (long long)(seconds > 0 ? references.size() / seconds : 0) << "\t" << faults << endl;
         }
-        page_faults++;
     }
-    return page_faults;
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
     // Parámetros por defecto
     int num_frames = 3;
+    int max_frames = 3;     // Último tamaño del barrido (igual a num_frames si no hay rango)
+    int frame_step = 1;     // Paso entre tamaños del barrido
+    bool sweep = false;     // Modo barrido: -m A:B[:PASO]
     string algorithm = "FIFO";
     string filename;
+    string output_filename; // Si se indica -o, solo se convierte la traza a formato binario
+    bool stream = false;    // Modo flujo: leer la traza por bloques sin cargarla completa
+    size_t lookahead = 1 << 20;  // Ventana de anticipación de OPTIMO en modo flujo (-l)
+    bool translation = false;    // Modelar la traducción de direcciones (-t, -tlb, -tlbpol, -huge)
+    int table_levels = 4;        // Tabla de páginas: 0 = hash, 2 o 4 niveles radix
+    size_t tlb_entries = 64;
+    size_t tlb_ways = 4;
+    TLB::Replacement tlb_policy = TLB::TLB_LRU;
+    bool huge_pages = false;
+    string stats_filename;       // Estadísticas por ventana (-e, CSV o JSON según la extensión)
+    string events_filename;      // Registro de eventos por referencia (-eventos)
+    long long stats_window = 10000;
+    uint32_t stats_sampling = 1;
+    string multiprogram;         // Traza de varios procesos (-procesos global|local)
+    size_t ws_tau = 0;           // Conjunto de trabajo con ventana tau (-ws)
+    size_t pff_lower = 0;        // Umbrales de PFF en referencias entre fallos (-pff BAJO:ALTO)
+    size_t pff_upper = 0;
+    bool bench = false;          // Microbenchmark con trazas sintéticas (-bench), sin -f
+    size_t bench_length = 1 << 21;
+    string generator;            // Traza sintética en vez de -f (-g MODELO:REFERENCIAS:PÁGINAS[:...])
+    uint32_t seed = 12345;       // Semilla del generador (-semilla)
+    int num_sets = 0;            // Simulación asociativa por conjuntos (-conjuntos), 0 = desactivada
+    size_t num_threads = 0;      // Hilos para -conjuntos (-hilos), 0 = uno por núcleo
+    CheckpointOptions checkpoint = {"", "", "", 0, 0};  // Puntos de control (-punto, -cada, -reanudar)
 
     // Parseo de argumentos
     for (int i = 1; i < argc; ++i) {
         if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
-            num_frames = atoi(argv[++i]);
+            if (!parseFrameRange(argv[++i], num_frames, max_frames, frame_step, sweep)) {
+                cerr << "Número de marcos inválido: " << argv[i] << endl;
+                return 1;
+            }
         } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
             algorithm = argv[++i];
         } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
             filename = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_filename = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            translation = true;
+            string type = argv[++i];
+            table_levels = (type == "hash") ? 0 : atoi(type.c_str());
+            if (table_levels != 0 && table_levels != 2 && table_levels != 4) {
+                cerr << "Tabla de páginas inválida (use hash, 2 o 4): " << type << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-tlb") == 0 && i + 1 < argc) {
+            translation = true;
+            string spec = argv[++i];  // ENTRADAS[:VÍAS]
+            size_t colon = spec.find(':');
+            tlb_entries = strtoull(spec.substr(0, colon).c_str(), nullptr, 10);
+            tlb_ways = (colon == string::npos) ? tlb_entries : strtoull(spec.substr(colon + 1).c_str(), nullptr, 10);
+            if (tlb_entries == 0 || tlb_ways == 0 || tlb_ways > tlb_entries || tlb_entries % tlb_ways != 0) {
+                cerr << "TLB inválida (use ENTRADAS[:VÍAS], con VÍAS divisor de ENTRADAS): " << spec << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-tlbpol") == 0 && i + 1 < argc) {
+            translation = true;
+            string name = argv[++i];
+            if (name == "LRU") {
+                tlb_policy = TLB::TLB_LRU;
+            } else if (name == "FIFO") {
+                tlb_policy = TLB::TLB_FIFO;
+            } else if (name == "RAND") {
+                tlb_policy = TLB::TLB_RANDOM;
+            } else {
+                cerr << "Política de TLB desconocida (use LRU, FIFO o RAND): " << name << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-huge") == 0) {
+            translation = true;
+            huge_pages = true;
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            stats_filename = argv[++i];
+        } else if (strcmp(argv[i], "-eventos") == 0 && i + 1 < argc) {
+            events_filename = argv[++i];
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            stats_window = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-muestreo") == 0 && i + 1 < argc) {
+            stats_sampling = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-procesos") == 0 && i + 1 < argc) {
+            multiprogram = argv[++i];
+            if (multiprogram != "global" && multiprogram != "local") {
+                cerr << "Modo de reemplazo inválido (use global o local): " << multiprogram << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-ws") == 0 && i + 1 < argc) {
+            ws_tau = strtoull(argv[++i], nullptr, 10);
+            if (ws_tau == 0) {
+                cerr << "Ventana del conjunto de trabajo inválida: " << argv[i] << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-pff") == 0 && i + 1 < argc) {
+            string spec = argv[++i];  // BAJO:ALTO, o un solo umbral T para ambos
+            size_t colon = spec.find(':');
+            pff_lower = strtoull(spec.substr(0, colon).c_str(), nullptr, 10);
+            pff_upper = (colon == string::npos) ? pff_lower : strtoull(spec.substr(colon + 1).c_str(), nullptr, 10);
+            if (pff_lower == 0 || pff_upper < pff_lower) {
+                cerr << "Umbrales de PFF inválidos (use BAJO:ALTO con BAJO <= ALTO): " << spec << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-bench") == 0) {
+            bench = true;
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            bench_length = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            generator = argv[++i];
+        } else if (strcmp(argv[i], "-semilla") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-conjuntos") == 0 && i + 1 < argc) {
+            num_sets = atoi(argv[++i]);
+            if (num_sets < 1) {
+                cerr << "Número de conjuntos inválido: " << argv[i] << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-hilos") == 0 && i + 1 < argc) {
+            num_threads = strtoull(argv[++i], nullptr, 10);
+            if (num_threads == 0) {
+                cerr << "Número de hilos inválido: " << argv[i] << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-punto") == 0 && i + 1 < argc) {
+            checkpoint.save_to = argv[++i];
+        } else if (strcmp(argv[i], "-cada") == 0 && i + 1 < argc) {
+            checkpoint.every = strtoull(argv[++i], nullptr, 10);
+            if (checkpoint.every == 0) {
+                cerr << "Intervalo de puntos de control inválido: " << argv[i] << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-reanudar") == 0 && i + 1 < argc) {
+            checkpoint.resume_from = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0) {
+            stream = true;
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            stream = true;
+            lookahead = strtoull(argv[++i], nullptr, 10);
         } else {
             cerr << "Parámetro desconocido o faltante: " << argv[i] << endl;
             return 1;
@@ -266,35 +3926,233 @@ int main(int argc, char* argv[]) {
     }
 
     // Verificar que se proporcionó el archivo de referencias
-    if (filename.empty()) {
+    SyntheticSpec synthetic;
+    if (!generator.empty()) {
+        if (!filename.empty() || !parseSyntheticSpec(generator, seed, synthetic)) {
+            cerr << "Traza sintética inválida (use -g MODELO:REFERENCIAS:PÁGINAS[:PARÁMETRO[:LARGO_FASE]] sin -f): "
+                 << generator << endl;
+            return 1;
+        }
+    }
+    // Abre la traza pedida: el archivo de -f o el generador de -g
+    auto openInput = [&]() {
+        return generator.empty() ? openTraceSource(filename)
+                                 : unique_ptr<TraceSource>(new SyntheticTraceSource(synthetic));
+    };
+
+    if (filename.empty() && generator.empty() && !bench) {
         cerr << "Debe proporcionar un archivo de referencias con el parámetro -f" << endl;
         return 1;
     }
 
+    // Resolver el o los algoritmos pedidos con -a
+    vector<const AlgorithmInfo*> selected;
+    if (!parseAlgorithmList(algorithm, selected)) {
+        return 1;
+    }
+    if (bench) {
+        if (sweep || bench_length == 0) {
+            cerr << "El modo -bench usa un único -m y -n mayor que 0" << endl;
+            return 1;
+        }
+        return runBenchmark(selected, num_frames, bench_length);
+    }
+    if (selected.size() > 1 && (stream || sweep)) {
+        cerr << "Varios algoritmos (-a ALL o lista) solo se pueden usar sin -s/-l y con un único -m" << endl;
+        return 1;
+    }
+    // Modo multiprogramado: traza PID:PÁGINA con marcos compartidos entre procesos
+    if (!multiprogram.empty()) {
+        if (!generator.empty() || selected.size() > 1 || sweep || stream || translation || !stats_filename.empty() ||
+            !events_filename.empty() || !output_filename.empty() || ws_tau > 0 || pff_lower > 0 || num_sets > 0 ||
+            num_threads > 0 || !checkpoint.save_to.empty() || !checkpoint.resume_from.empty() || checkpoint.every > 0) {
+            cerr << "El modo -procesos se usa con un solo algoritmo y un único -m, sin -g, -s, -t, -e, -eventos, -o, "
+                 << "-ws, -pff, -conjuntos, -hilos, -punto, -reanudar ni -cada" << endl;
+            return 1;
+        }
+        return simulateMultiprogram(*selected[0], readProcessTrace(filename), num_frames, multiprogram == "global");
+    }
+
+    if (!events_filename.empty() && stats_filename.empty()) {
+        cerr << "El registro de eventos (-eventos) se usa junto con -e" << endl;
+        return 1;
+    }
+    if ((translation || !stats_filename.empty()) && (selected.size() > 1 || sweep)) {
+        cerr << "La traducción de direcciones y las estadísticas se miden para un solo algoritmo y un único -m" << endl;
+        return 1;
+    }
+
+    // Observadores de la simulación; sin ninguno se usa el ciclo sin instrumentación
+    ObserverList observers;
+    unique_ptr<TranslationModel> translation_model;
+    if (translation) {
+        translation_model.reset(new TranslationModel(table_levels, tlb_entries, tlb_ways, tlb_policy, huge_pages));
+        observers.add(translation_model.get());
+    }
+    unique_ptr<StatsObserver> stats;
+    if (!stats_filename.empty()) {
+        stats.reset(new StatsObserver(stats_filename, stats_window, stats_sampling, events_filename));
+        observers.add(stats.get());
+    }
+
+    // Asignación dinámica: el número de marcos lo decide -ws o -pff en vez de -m
+    bool dynamic_allocation = ws_tau > 0 || pff_lower > 0;
+    if (dynamic_allocation && (selected.size() > 1 || sweep || stream || !output_filename.empty() || (ws_tau > 0 && pff_lower > 0))) {
+        cerr << "-ws y -pff se usan por separado, sin -a con varios algoritmos, -m A:B, -s, -l ni -o" << endl;
+        return 1;
+    }
+
+    if (num_sets > 0) {
+        if (sweep || stream || translation || !stats_filename.empty() || dynamic_allocation || !output_filename.empty()) {
+            cerr << "-conjuntos se usa con un único -m, sin -s, -l, -t, -e, -ws, -pff ni -o" << endl;
+            return 1;
+        }
+        if (num_frames % num_sets != 0) {
+            cerr << "El número de marcos (" << num_frames << ") debe ser múltiplo del de conjuntos (" << num_sets
+                 << ")" << endl;
+            return 1;
+        }
+    }
+
+    bool checkpointing = !checkpoint.save_to.empty() || !checkpoint.resume_from.empty();
+    if (checkpoint.every > 0 && checkpoint.save_to.empty()) {
+        cerr << "-cada indica cada cuántas referencias guardar el punto de control de -punto" << endl;
+        return 1;
+    }
+    if (checkpointing && sweep) {
+        cerr << "Los barridos de marcos (-m A:B) no admiten puntos de control (-punto, -reanudar); "
+             << "use un único -m" << endl;
+        return 1;
+    }
+    if (checkpointing && (selected.size() > 1 || stream || dynamic_allocation || num_sets > 0 || !output_filename.empty())) {
+        cerr << "Los puntos de control (-punto, -reanudar) se usan con un solo algoritmo y un único -m, sin -s, -l, -ws, -pff, -conjuntos ni -o" << endl;
+        return 1;
+    }
+
+    // Modo conversión: escribir la traza en formato binario y terminar
+    if (!output_filename.empty()) {
+        return convertTrace(*openInput(), output_filename);
+    }
+
+    // Modo flujo: la traza nunca se carga completa en memoria
+    if (stream) {
+        if (sweep) {
+            cerr << "El modo barrido (-m A:B) necesita la traza completa y no se puede usar con -s/-l" << endl;
+            return 1;
+        }
+        unique_ptr<TraceSource> source = openInput();
+        long long page_faults = selected[0]->simulate_stream(*source, num_frames, lookahead, observers.get());
+        cout << "Número de fallos de página: " << page_faults << endl;
+        if (translation_model) {
+            translation_model->report(cout);
+        }
+        if (stats) {
+            stats->finish();
+        }
+        return 0;
+    }
+
     // Leer las referencias desde el archivo
-    vector<int> references = readReferences(filename);
-
-    // Crear la tabla de páginas (el tamaño de la tabla hash puede ser arbitrario)
-    PageTable page_table(10);
-
-    int page_faults = 0;
-
-    // Simular según el algoritmo elegido
-    if (algorithm == "FIFO") {
-        page_faults = simulateFIFO(references, num_frames);
-    } else if (algorithm == "LRU") {
-        page_faults = simulateLRU(references, num_frames);
-    } else if (algorithm == "OPTIMO" || algorithm == "OPT") {
-        page_faults = simulateOptimal(references, num_frames);
-    } else if (algorithm == "RELOJ" || algorithm == "CLOCK") {
-        page_faults = simulateClock(references, num_frames);
+    vector<int> references = generator.empty() ? readReferences(filename) : readAllReferences(*openInput());
+
+    // Asociativa por conjuntos: un hilo por conjunto (y algoritmo) con los fallos sumados
+    if (num_sets > 0) {
+        if (num_threads == 0) {
+            num_threads = max(thread::hardware_concurrency(), 1u);
+        }
+        vector<long long> faults = simulateSetAssociative(references, num_frames, num_sets, selected, num_threads);
+        if (selected.size() == 1) {
+            cout << "Número de fallos de página: " << faults[0] << endl;
+        } else {
+            cout << "Algoritmo\tFallos de página" << endl;
+            for (size_t i = 0; i < selected.size(); ++i) {
+                cout << selected[i]->name << "\t" << faults[i] << endl;
+            }
+        }
+        return 0;
+    }
+
+    // Asignación dinámica: informar la memoria promedio y compararla con una partición fija
+    if (dynamic_allocation) {
+        NullObserver none;
+        ReferenceObserver* observer = observers.get();
+        AllocationResult result = observer != nullptr
+                                      ? simulateAllocation(references, ws_tau, pff_lower, pff_upper, *observer)
+                                      : simulateAllocation(references, ws_tau, pff_lower, pff_upper, none);
+        cout << "Número de fallos de página: " << result.faults << endl;
+        cout << "Tasa de fallos: " << (references.empty() ? 0.0 : (double)result.faults / references.size()) << endl;
+        cout << "Marcos promedio: " << result.average_frames << " (máximo " << result.peak_frames << ")" << endl;
+
+        // Menor número fijo de marcos con el que LRU no supera esos fallos
+        vector<long long> lru_faults = sweepLRU(references, (int)max(result.peak_frames, (size_t)1) * 2);
+        for (size_t m = 1; m < lru_faults.size(); ++m) {
+            if (lru_faults[m] <= result.faults) {
+                cout << "LRU con marcos fijos necesita " << m << " marcos para igualarlo (ahorro de memoria: "
+                     << 100.0 * (1.0 - result.average_frames / m) << "%)" << endl;
+                break;
+            }
+            if (m + 1 == lru_faults.size()) {
+                cout << "LRU con marcos fijos no lo iguala con hasta " << m << " marcos" << endl;
+            }
+        }
+        if (translation_model) {
+            translation_model->report(cout);
+        }
+        if (stats) {
+            stats->finish();
+        }
+        return 0;
+    }
+
+    // Modo barrido: entregar los fallos para cada tamaño del rango
+    if (sweep) {
+        vector<long long> faults(max_frames + 1, 0);
+        if (selected[0]->sweep != nullptr) {
+            faults = selected[0]->sweep(references, max_frames);
+        } else {
+            // FIFO y Reloj no son algoritmos de pila: simular cada tamaño sobre el mismo buffer
+            for (int m = num_frames; m <= max_frames; m += frame_step) {
+                faults[m] = selected[0]->simulate(references, m, nullptr);
+            }
+        }
+
+        cout << "Marcos\tFallos de página" << endl;
+        for (int m = num_frames; m <= max_frames; m += frame_step) {
+            cout << m << "\t" << faults[m] << endl;
+        }
+        return 0;
+    }
+
+    // Varios algoritmos: simularlos en paralelo sobre la misma traza e imprimir una tabla
+    if (selected.size() > 1) {
+        vector<long long> faults = simulateParallel(references, num_frames, selected);
+        cout << "Algoritmo\tFallos de página" << endl;
+        for (size_t i = 0; i < selected.size(); ++i) {
+            cout << selected[i]->name << "\t" << faults[i] << endl;
+        }
+        return 0;
+    }
+
+    // Simular según el algoritmo elegido; con puntos de control solo se simulan las
+    // referencias posteriores a la posición guardada
+    long long page_faults;
+    if (checkpointing) {
+        checkpoint.algorithm = selected[0]->name;
+        page_faults = selected[0]->simulate_checkpointed(references, num_frames, checkpoint, observers.get());
+        cout << "Referencias simuladas: " << references.size() - checkpoint.resumed_at << " (desde la posición "
+             << checkpoint.resumed_at << ")" << endl;
     } else {
-        cerr << "Algoritmo desconocido: " << algorithm << endl;
-        return 1;
+        page_faults = selected[0]->simulate(references, num_frames, observers.get());
     }
 
     // Imprimir el número de fallos de página
     cout << "Número de fallos de página: " << page_faults << endl;
+    if (translation_model) {
+        translation_model->report(cout);
+    }
+    if (stats) {
+        stats->finish();
+    }
 
     return 0;
 }
@@ -7,144 +7,2171 @@
 #include <chrono>               // Para manejo de tiempo
 #include <queue>                // (No se usa en este código, pero puede ser útil)
 #include <cstring>              // Para manejo de cadenas de caracteres C
+#include <atomic>               // Para la cola sin bloqueo (MPMC) y el registro asíncrono
+#include <memory>               // Para unique_ptr y uninitialized_copy_n
+#include <type_traits>          // Para aligned_storage en los segmentos de la cola genérica
+#include <utility>              // Para move y forward al encolar elementos movibles
+#include <iterator>             // Para advance y make_move_iterator en los lotes
+#include <random>               // Para los tiempos de servicio exponenciales
+#include <cstdio>               // Para snprintf() en el registro asíncrono
+#include <pthread.h>            // Para pthread_setaffinity_np() al fijar hilos a núcleos
+#include <sched.h>              // Para cpu_set_t y sched_getcpu()
 
 using namespace std;
 
-// Clase Monitor para manejar la cola circular de tamaño dinámico
+// Item que circula por la cola: el valor, el instante en que el productor lo entregó (para
+// medir la latencia de extremo a extremo en el consumidor), el nodo NUMA del productor, su
+// clase de prioridad y una carga opcional en el heap que el productor llena y el consumidor
+// lee y libera (-carga)
+struct Item {
+    int value;
+    int node;               // Nodo NUMA donde se produjo, para contar los cruces entre nodos
+    int priority;           // Clase del item (0 = la más urgente), ver -mezcla y -cola prioridad
+    long long produced_ns;
+    char* payload;
+};
+
+// Instante actual en nanosegundos del reloj monótono (común a todos los hilos)
+static long long now_ns() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Interpretar una lista de CPUs o nodos como "0-3,8,10-11" (el formato de /sys)
+static bool parse_cpu_list(const string& text, vector<int>& ids) {
+    ids.clear();
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t comma = text.find(',', position);
+        string part = text.substr(position, comma == string::npos ? string::npos : comma - position);
+        char* end = nullptr;
+        long first = strtol(part.c_str(), &end, 10);
+        long last = first;
+        if (end == part.c_str()) {
+            return false;
+        }
+        if (*end == '-') {
+            const char* second = end + 1;
+            last = strtol(second, &end, 10);
+            if (end == second) {
+                return false;
+            }
+        }
+        if (*end != '\0' && *end != '\n') {
+            return false;
+        }
+        if (first < 0 || last < first || last >= CPU_SETSIZE) {
+            return false;
+        }
+        for (long id = first; id <= last; ++id) {
+            ids.push_back((int)id);
+        }
+        if (comma == string::npos) {
+            break;
+        }
+        position = comma + 1;
+    }
+    return !ids.empty();
+}
+
+// Topología NUMA leída de /sys/devices/system/node: las CPUs de cada nodo y el nodo de cada
+// CPU. Sin esa información (otro sistema, contenedor) se asume un solo nodo con todas las
+// CPUs.
+struct NumaTopology {
+    vector<int> node_ids;           // Nodos en línea
+    vector<vector<int>> node_cpus;  // CPUs de cada nodo, en el orden de node_ids
+    vector<int> cpu_node;           // Nodo de cada CPU (-1 si no se conoce)
+
+    NumaTopology() {
+        ifstream online("/sys/devices/system/node/online");
+        string line;
+        if (getline(online, line) && parse_cpu_list(line, node_ids)) {
+            for (int node : node_ids) {
+                ifstream cpulist("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+                vector<int> cpus;
+                if (getline(cpulist, line) && parse_cpu_list(line, cpus)) {
+                    node_cpus.push_back(cpus);
+                } else {
+                    node_cpus.push_back(vector<int>());
+                }
+            }
+        }
+        if (node_ids.empty()) {
+            int cpus = max(1u, thread::hardware_concurrency());
+            node_ids.assign(1, 0);
+            node_cpus.assign(1, vector<int>());
+            for (int cpu = 0; cpu < cpus; ++cpu) {
+                node_cpus[0].push_back(cpu);
+            }
+        }
+        for (size_t n = 0; n < node_ids.size(); ++n) {
+            for (int cpu : node_cpus[n]) {
+                if (cpu >= (int)cpu_node.size()) {
+                    cpu_node.resize(cpu + 1, -1);
+                }
+                cpu_node[cpu] = node_ids[n];
+            }
+        }
+    }
+
+    // CPUs del nodo indicado, o nullptr si no existe
+    const vector<int>* cpus_of(int node) const {
+        for (size_t n = 0; n < node_ids.size(); ++n) {
+            if (node_ids[n] == node) {
+                return &node_cpus[n];
+            }
+        }
+        return nullptr;
+    }
+};
+
+static const NumaTopology& numa_topology() {
+    static const NumaTopology topology;
+    return topology;
+}
+
+// Nodo NUMA en el que corre ahora el hilo (0 si hay un solo nodo)
+static int current_node() {
+    const NumaTopology& topology = numa_topology();
+    if (topology.node_ids.size() <= 1) {
+        return topology.node_ids[0];
+    }
+    int cpu = sched_getcpu();
+    return (cpu >= 0 && cpu < (int)topology.cpu_node.size()) ? topology.cpu_node[cpu] : -1;
+}
+
+// Fijar un hilo a un conjunto de CPUs; false si el sistema lo rechaza
+static bool set_thread_affinity(pthread_t handle, const vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(handle, sizeof(set), &set) == 0;
+}
+
+// Ubicación de un grupo de hilos (-afinidad-p, -afinidad-c): sin fijar, una CPU por hilo
+// tomada por turno de una lista (cpus:LISTA), o cualquier CPU de un nodo (nodo:N)
+struct ThreadPlacement {
+    enum Kind { ANY, CPU_PER_THREAD, NODE } kind;
+    vector<int> cpus;
+
+    ThreadPlacement() : kind(ANY) {}
+
+    // CPUs permitidas al hilo número index del grupo
+    vector<int> cpus_for(int index) const {
+        if (kind == CPU_PER_THREAD) {
+            return vector<int>(1, cpus[index % cpus.size()]);
+        }
+        return cpus;
+    }
+
+    void apply(thread& worker, int index) const {
+        if (kind != ANY && !set_thread_affinity(worker.native_handle(), cpus_for(index))) {
+            cerr << "No se pudo fijar la afinidad del hilo " << index << "." << endl;
+        }
+    }
+};
+
+// Interpretar cpus:LISTA o nodo:N
+static bool parse_thread_placement(const string& text, ThreadPlacement& placement) {
+    if (text.compare(0, 5, "cpus:") == 0) {
+        placement.kind = ThreadPlacement::CPU_PER_THREAD;
+        return parse_cpu_list(text.substr(5), placement.cpus);
+    }
+    if (text.compare(0, 5, "nodo:") == 0) {
+        const vector<int>* cpus = numa_topology().cpus_of(atoi(text.c_str() + 5));
+        if (cpus == nullptr || cpus->empty()) {
+            return false;
+        }
+        placement.kind = ThreadPlacement::NODE;
+        placement.cpus = *cpus;
+        return true;
+    }
+    return false;
+}
+
+// Fija el hilo actual a las CPUs de un nodo mientras se construye la cola, para que sus
+// búferes queden en la memoria de ese nodo (política de primer toque de Linux), y luego
+// devuelve la afinidad original antes de crear los demás hilos (que la heredarían). Una
+// página se asigna al escribirla por primera vez, no al reservarla, así que cada cola
+// escribe su memoria inicial en el constructor.
+class ScopedAffinity {
+private:
+    cpu_set_t saved;
+    bool active;
+
+public:
+    explicit ScopedAffinity(const vector<int>* cpus) : active(false) {
+        if (cpus != nullptr &&
+            pthread_getaffinity_np(pthread_self(), sizeof(saved), &saved) == 0) {
+            active = set_thread_affinity(pthread_self(), *cpus);
+        }
+    }
+
+    ~ScopedAffinity() {
+        restore();
+    }
+
+    void restore() {
+        if (active) {
+            pthread_setaffinity_np(pthread_self(), sizeof(saved), &saved);
+            active = false;
+        }
+    }
+};
+
+// Arena de cargas de tamaño fijo (-arena): reserva los bloques de a PAYLOADS_PER_SLAB en
+// una sola llamada a new y recicla los liberados en una lista libre, así producir y consumir
+// cargas grandes no cuesta una reserva y liberación del heap por item. La lista libre se
+// guarda dentro de los propios bloques libres.
+class PayloadPool {
+private:
+    static const size_t PAYLOADS_PER_SLAB = 256;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    size_t block_size;               // Tamaño de cada bloque (la carga redondeada)
+    vector<unique_ptr<char[]>> slabs; // Memoria reservada, se libera con la arena
+    FreeBlock* free_list;
+    mutex mtx;
+
+public:
+    explicit PayloadPool(size_t payload_size)
+        : block_size((max(payload_size, sizeof(FreeBlock)) + alignof(max_align_t) - 1) / alignof(max_align_t) *
+                     alignof(max_align_t)),
+          free_list(nullptr) {}
+
+    PayloadPool(const PayloadPool&) = delete;
+    PayloadPool& operator=(const PayloadPool&) = delete;
+
+    char* allocate() {
+        lock_guard<mutex> lock(mtx);
+        if (free_list == nullptr) {
+            // Reservar un bloque grande nuevo y partirlo en cargas
+            char* slab = new char[block_size * PAYLOADS_PER_SLAB];
+            slabs.emplace_back(slab);
+            for (size_t i = 0; i < PAYLOADS_PER_SLAB; ++i) {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + i * block_size);
+                block->next = free_list;
+                free_list = block;
+            }
+        }
+        FreeBlock* block = free_list;
+        free_list = block->next;
+        return reinterpret_cast<char*>(block);
+    }
+
+    void release(char* payload) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(payload);
+        lock_guard<mutex> lock(mtx);
+        block->next = free_list;
+        free_list = block;
+    }
+
+    // Bytes reservados en total (para el resumen)
+    size_t reserved_bytes() {
+        lock_guard<mutex> lock(mtx);
+        return slabs.size() * PAYLOADS_PER_SLAB * block_size;
+    }
+};
+
+// Registro asíncrono: los hilos dejan registros de tamaño fijo (instante, mensaje y valor)
+// en un anillo sin bloqueo y un hilo escritor los vacía al archivo con escrituras en búfer.
+// Registrar cuesta un CAS y nunca hace una llamada al sistema, así que se puede llamar con
+// el mutex de la cola tomado. Si el anillo se llena el registro se descarta y se cuenta.
+class AsyncLogger {
+private:
+    static const size_t RING_SIZE = 1 << 14; // Registros en vuelo (potencia de dos)
+
+    struct Record {
+        atomic<size_t> sequence;
+        long long nanoseconds;   // Desde que se creó el registro asíncrono
+        const char* message;     // Literal, no se copia
+        long long value;
+    };
+
+    vector<Record> ring;
+    alignas(64) atomic<size_t> write_pos;  // Próxima casilla para los hilos que registran
+    alignas(64) size_t read_pos;           // Solo lo usa el hilo escritor
+    atomic<long long> dropped;
+    atomic<bool> running;
+    chrono::steady_clock::time_point start;
+    ofstream& out;
+    thread writer;
+
+    // Escribir todos los registros publicados; false si no había ninguno
+    bool drain() {
+        bool wrote = false;
+        while (true) {
+            Record& record = ring[read_pos & (RING_SIZE - 1)];
+            if (record.sequence.load(memory_order_acquire) != read_pos + 1) {
+                return wrote;
+            }
+            char stamp[32];
+            snprintf(stamp, sizeof(stamp), "[%.6f] ", record.nanoseconds / 1e9);
+            out << stamp << record.message << record.value << '\n';
+            record.sequence.store(read_pos + RING_SIZE, memory_order_release);
+            ++read_pos;
+            wrote = true;
+        }
+    }
+
+    void writer_loop() {
+        while (running.load(memory_order_acquire)) {
+            if (!drain()) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        }
+        drain();
+    }
+
+public:
+    AsyncLogger(ofstream& out_ref)
+        : ring(RING_SIZE), write_pos(0), read_pos(0), dropped(0), running(true), start(chrono::steady_clock::now()),
+          out(out_ref) {
+        for (size_t i = 0; i < RING_SIZE; ++i) {
+            ring[i].sequence.store(i, memory_order_relaxed);
+        }
+        writer = thread(&AsyncLogger::writer_loop, this);
+    }
+
+    ~AsyncLogger() {
+        stop();
+    }
+
+    // Registrar message seguido de value (message debe ser un literal)
+    void log(const char* message, long long value) {
+        size_t pos = write_pos.load(memory_order_relaxed);
+        Record* record;
+        while (true) {
+            record = &ring[pos & (RING_SIZE - 1)];
+            intptr_t diff = (intptr_t)record->sequence.load(memory_order_acquire) - (intptr_t)pos;
+            if (diff == 0) {
+                if (write_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                dropped.fetch_add(1, memory_order_relaxed); // Anillo lleno: el escritor va atrasado
+                return;
+            } else {
+                pos = write_pos.load(memory_order_relaxed);
+            }
+        }
+        record->nanoseconds = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        record->message = message;
+        record->value = value;
+        record->sequence.store(pos + 1, memory_order_release);
+    }
+
+    // Terminar el hilo escritor después de vaciar el anillo
+    void stop() {
+        if (writer.joinable()) {
+            running.store(false, memory_order_release);
+            writer.join();
+            if (dropped.load() > 0) {
+                out << "Registros descartados por anillo lleno: " << dropped.load() << '\n';
+            }
+            out.flush();
+        }
+    }
+};
+
+// Anillo segmentado de tamaño dinámico, genérico sobre el tipo de elemento T (basta con que
+// se pueda mover: sirve para tareas con unique_ptr, etc.). No se sincroniza: lo usan los
+// monitores con su mutex tomado. Los elementos viven en segmentos de tamaño fijo enlazados:
+// para crecer basta con enlazar un segmento nuevo al final y para achicarse se devuelve el
+// segmento ya consumido del frente, así que cambiar de tamaño nunca copia ni mueve
+// elementos. Las casillas son memoria sin construir: cada elemento se construye en su
+// lugar al encolar (emplace) y se destruye al extraerlo, así T no necesita constructor por
+// defecto. Los segmentos libres se guardan en un pool acotado por la capacidad actual.
+template <typename T>
+class SegmentedRing {
+private:
+    static const size_t SEGMENT_SIZE = 64; // Elementos por segmento
+
+    struct Segment {
+        typename aligned_storage<sizeof(T), alignof(T)>::type slots[SEGMENT_SIZE];
+        Segment* next;
+
+        T* at(size_t index) {
+            return reinterpret_cast<T*>(&slots[index]);
+        }
+    };
+
+    Segment* head;                // Segmento del frente del anillo
+    Segment* tail;                // Segmento del final del anillo
+    size_t head_index;            // Próxima posición a leer en head
+    size_t tail_index;            // Próxima posición a escribir en tail
+    Segment* free_segments;       // Pool de segmentos libres
+    size_t total_segments;        // Segmentos en uso más los del pool
+
+    size_t capacity;              // Capacidad actual del anillo
+    size_t min_capacity;          // El anillo no se achica por debajo de la capacidad inicial, así
+                                  // conserva los segmentos que el constructor ya escribió
+    size_t count;                 // Número de elementos actuales en el anillo
+
+    AsyncLogger& logger;          // Registro asíncrono de los cambios de tamaño
+    const char* resize_message;   // Mensaje del registro al cambiar de tamaño
+
+    // Segmentos que se conservan para la capacidad actual (uno extra para el frente parcial)
+    size_t segment_limit() const {
+        return (capacity + SEGMENT_SIZE - 1) / SEGMENT_SIZE + 1;
+    }
+
+    // Tomar un segmento del pool o pedir uno nuevo
+    Segment* acquire_segment() {
+        Segment* segment = free_segments;
+        if (segment != nullptr) {
+            free_segments = segment->next;
+        } else {
+            segment = new Segment;
+            ++total_segments;
+        }
+        segment->next = nullptr;
+        return segment;
+    }
+
+    // Devolver un segmento al pool, o liberarlo si sobra para la capacidad actual
+    void release_segment(Segment* segment) {
+        if (total_segments > segment_limit()) {
+            delete segment;
+            --total_segments;
+        } else {
+            segment->next = free_segments;
+            free_segments = segment;
+        }
+    }
+
+    // Función para redimensionar el anillo: solo cambia el límite, en O(1). Al achicarse se
+    // suelta a lo sumo un segmento del pool; el resto se libera a medida que se consumen.
+    void resize(size_t new_capacity) {
+        capacity = new_capacity;   // Actualizar la capacidad
+        if (free_segments != nullptr && total_segments > segment_limit()) {
+            Segment* extra = free_segments;
+            free_segments = extra->next;
+            delete extra;
+            --total_segments;
+        }
+
+        // Registrar en el log el cambio de tamaño
+        logger.log(resize_message, (long long)capacity);
+    }
+
+    // Segmento del frente listo para leer, devolviendo al pool el ya consumido
+    void advance_head() {
+        if (head_index == SEGMENT_SIZE) {
+            Segment* consumed = head;
+            head = head->next;
+            head_index = 0;
+            release_segment(consumed);
+        }
+    }
+
+    // Segmento del final listo para escribir, enlazando uno nuevo si el último se llenó
+    void advance_tail() {
+        if (tail_index == SEGMENT_SIZE) {
+            tail->next = acquire_segment();
+            tail = tail->next;
+            tail_index = 0;
+        }
+    }
+
+    // Cola vacía: reutilizar el segmento desde el inicio
+    void rewind_if_empty() {
+        if (count == 0) {
+            head_index = tail_index = 0;
+        }
+    }
+
+    // Histéresis: reducir a la mitad solo con un uso del 12.5% o menos, así el anillo queda
+    // al 25% tras achicarse y no vuelve a crecer enseguida; nunca bajo la capacidad inicial
+    bool should_shrink() const {
+        return capacity / 2 >= min_capacity && count <= capacity / 8;
+    }
+
+public:
+    // Los segmentos de la capacidad inicial se reservan y se escriben aquí, así sus páginas
+    // se asignan (primer toque) en el nodo del hilo que construye la cola (-nodo-cola) y no
+    // en el del primer productor que llegue a usarlos
+    SegmentedRing(size_t init_capacity, AsyncLogger& logger_ref, const char* message)
+        : head(nullptr), tail(nullptr), head_index(0), tail_index(0), free_segments(nullptr), total_segments(0),
+          capacity(max(init_capacity, (size_t)1)), min_capacity(capacity), count(0), logger(logger_ref),
+          resize_message(message) {
+        while (total_segments < segment_limit()) {
+            Segment* segment = new Segment;
+            memset(segment->slots, 0, sizeof(segment->slots));
+            segment->next = free_segments;
+            free_segments = segment;
+            ++total_segments;
+        }
+        head = tail = acquire_segment();
+    }
+
+    SegmentedRing(const SegmentedRing&) = delete;
+    SegmentedRing& operator=(const SegmentedRing&) = delete;
+
+    ~SegmentedRing() {
+        // Destruir los elementos que no se llegaron a extraer
+        Segment* segment = head;
+        size_t index = head_index;
+        for (size_t left = count; left > 0; --left) {
+            if (index == SEGMENT_SIZE) {
+                segment = segment->next;
+                index = 0;
+            }
+            segment->at(index++)->~T();
+        }
+        while (head != nullptr) {
+            Segment* next = head->next;
+            delete head;
+            head = next;
+        }
+        while (free_segments != nullptr) {
+            Segment* next = free_segments->next;
+            delete free_segments;
+            free_segments = next;
+        }
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t current_capacity() const {
+        return capacity;
+    }
+
+    // Construir un elemento directamente en su casilla al final; si el anillo queda lleno,
+    // duplicar su tamaño
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        advance_tail();
+        new (tail->at(tail_index)) T(std::forward<Args>(args)...);
+        ++tail_index;
+        ++count;
+        if (count == capacity) {
+            resize(capacity * 2);
+        }
+    }
+
+    // Agregar n elementos construyéndolos por segmentos. Para mover en lugar de copiar basta
+    // con pasar make_move_iterator(items).
+    template <typename InputIt>
+    void append(InputIt items, size_t n) {
+        for (size_t done = 0; done < n;) {
+            advance_tail();
+            size_t chunk = min(n - done, SEGMENT_SIZE - tail_index);
+            uninitialized_copy_n(items, chunk, tail->at(tail_index));
+            advance(items, chunk);
+            tail_index += chunk;
+            count += chunk;
+            done += chunk;
+        }
+
+        // Duplicar el tamaño las veces necesarias para que el anillo no quede lleno
+        while (count >= capacity) {
+            resize(capacity * 2);
+        }
+    }
+
+    // Extraer el elemento del frente (el anillo no debe estar vacío)
+    void pop_front(T& item) {
+        advance_head();
+        T* slot = head->at(head_index++);
+        item = std::move(*slot);
+        slot->~T();
+        --count;
+        rewind_if_empty();
+        if (should_shrink()) {
+            resize(capacity / 2);
+        }
+    }
+
+    // Extraer hasta max_items elementos del frente por segmentos; devuelve cuántos
+    size_t pop_front_bulk(T* items, size_t max_items) {
+        size_t taken = min(max_items, count);
+        for (size_t done = 0; done < taken;) {
+            advance_head();
+            size_t chunk = min(taken - done, SEGMENT_SIZE - head_index);
+            for (size_t k = 0; k < chunk; ++k) {
+                T* slot = head->at(head_index + k);
+                items[done + k] = std::move(*slot);
+                slot->~T();
+            }
+            head_index += chunk;
+            done += chunk;
+        }
+        count -= taken;
+        rewind_if_empty();
+        while (should_shrink()) {
+            resize(capacity / 2);
+        }
+        return taken;
+    }
+};
+
+// Clase Monitor para manejar la cola circular de tamaño dinámico, genérica sobre el tipo
+// de elemento T. Los elementos se guardan en un anillo segmentado (SegmentedRing), así que
+// crecer o achicarse nunca copia ni mueve elementos.
+template <typename T>
 class CircularQueueMonitor {
 private:
-    vector<int> buffer;           // Vector que actúa como la cola circular
-    size_t capacity;              // Capacidad actual de la cola
-    size_t front;                 // Índice del frente de la cola
-    size_t rear;                  // Índice del final de la cola
-    size_t count;                 // Número de elementos actuales en la cola
+    SegmentedRing<T> ring;        // Elementos de la cola
 
     mutex mtx;                    // Mutex para sincronizar el acceso a la cola
     condition_variable not_full;  // Variable de condición para cuando la cola no está llena
     condition_variable not_empty; // Variable de condición para cuando la cola no está vacía
 
-    ofstream& log_file;           // Referencia al archivo de log para registrar los cambios
+public:
+    bool producers_done = false; // Indica si los productores han terminado
+
+    // Constructor de la clase
+    CircularQueueMonitor(size_t init_capacity, AsyncLogger& logger_ref)
+        : ring(init_capacity, logger_ref, "La cola cambió de tamaño a ") {}
+
+    // Función para agregar un elemento a la cola; siempre lo acepta porque la cola crece
+    bool enqueue(const T& item) {
+        emplace(item);
+        return true;
+    }
+
+    bool enqueue(T&& item) {
+        emplace(std::move(item));
+        return true;
+    }
+
+    // Construir un elemento directamente en su casilla al final de la cola
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        unique_lock<mutex> lock(mtx); // Adquirir el mutex
+
+        // Esperar mientras la cola esté llena
+        not_full.wait(lock, [this]() { return ring.size() < ring.current_capacity(); });
+
+        // Agregar el elemento al final; si la cola queda llena el anillo duplica su tamaño
+        ring.emplace_back(std::forward<Args>(args)...);
+
+        not_empty.notify_one(); // Notificar a un hilo que espera por elementos
+    }
+
+    // Función para extraer un elemento de la cola
+    bool dequeue(T& item) {
+        return pop_front(item, nullptr);
+    }
+
+    // Extraer un elemento esperando a lo sumo timeout; false si venció el plazo o si la
+    // cola está vacía y los productores han terminado
+    bool dequeue_for(T& item, chrono::steady_clock::duration timeout) {
+        return dequeue_until(item, chrono::steady_clock::now() + timeout);
+    }
+
+    bool dequeue_until(T& item, chrono::steady_clock::time_point deadline) {
+        return pop_front(item, &deadline);
+    }
+
+private:
+    // Esperar mientras la cola esté vacía y los productores no hayan terminado, o hasta
+    // deadline si se indica; true si hay elementos para extraer
+    bool wait_for_items(unique_lock<mutex>& lock, const chrono::steady_clock::time_point* deadline) {
+        while (ring.size() == 0 && !producers_done) {
+            if (deadline == nullptr) {
+                not_empty.wait(lock);
+            } else if (not_empty.wait_until(lock, *deadline) == cv_status::timeout) {
+                break;
+            }
+        }
+        return ring.size() > 0;
+    }
+
+    bool pop_front(T& item, const chrono::steady_clock::time_point* deadline) {
+        unique_lock<mutex> lock(mtx); // Adquirir el mutex
+
+        // Si la cola sigue vacía (productores terminados o plazo vencido), no hay elemento
+        if (!wait_for_items(lock, deadline)) {
+            return false;
+        }
+
+        // Extraer el elemento del frente; el anillo se achica si quedó poco usado
+        ring.pop_front(item);
+
+        not_full.notify_one(); // Notificar a un hilo que espera por espacio
+        return true;
+    }
+
+public:
+    // Agregar n elementos en una sola sección crítica, construyéndolos por segmentos y con
+    // una sola notificación para todo el lote. Para mover en lugar de copiar basta con pasar
+    // make_move_iterator(items). Devuelve cuántos se agregaron (siempre n).
+    template <typename InputIt>
+    size_t enqueue_bulk(InputIt items, size_t n) {
+        if (n == 0) {
+            return 0;
+        }
+        unique_lock<mutex> lock(mtx); // Adquirir el mutex
+        not_full.wait(lock, [this]() { return ring.size() < ring.current_capacity(); });
+
+        ring.append(items, n);
+
+        not_empty.notify_all(); // Puede haber elementos para varios consumidores
+        return n;
+    }
+
+    // Extraer hasta max_items elementos en una sola sección crítica; devuelve cuántos se
+    // extrajeron, 0 si la cola está vacía y los productores han terminado
+    size_t dequeue_bulk(T* items, size_t max_items) {
+        return pop_front_bulk(items, max_items, nullptr);
+    }
+
+    // Como dequeue_bulk, pero esperando a lo sumo hasta deadline (0 si venció el plazo)
+    size_t dequeue_bulk_until(T* items, size_t max_items, chrono::steady_clock::time_point deadline) {
+        return pop_front_bulk(items, max_items, &deadline);
+    }
+
+private:
+    size_t pop_front_bulk(T* items, size_t max_items, const chrono::steady_clock::time_point* deadline) {
+        unique_lock<mutex> lock(mtx); // Adquirir el mutex
+        if (!wait_for_items(lock, deadline)) {
+            return 0;
+        }
+
+        size_t taken = ring.pop_front_bulk(items, max_items);
+
+        not_full.notify_all(); // Se liberó espacio para varios productores
+        return taken;
+    }
+
+public:
+    // Vista de la cola para el consumidor consumer_id (la cola es compartida por todos)
+    CircularQueueMonitor& consumer(int) {
+        return *this;
+    }
+
+    // Elementos y capacidad actuales, para el muestreo de ocupación
+    void occupancy(size_t& items, size_t& current_capacity) {
+        lock_guard<mutex> lock(mtx);
+        items = ring.size();
+        current_capacity = ring.current_capacity();
+    }
+
+    // Función para indicar que los productores han terminado
+    void set_producers_done() {
+        unique_lock<mutex> lock(mtx); // Adquirir el mutex
+        producers_done = true;        // Marcar que los productores han terminado
+        not_empty.notify_all();       // Notificar a todos los hilos que esperan por elementos
+    }
+};
+
+// Política de extracción entre clases (-clases): estricta (siempre la clase más urgente con
+// items) o ponderada (turno rotativo en el que cada clase entrega hasta su peso seguido)
+struct ClassPolicy {
+    bool strict;
+    vector<int> weights;  // Una entrada por clase; en modo estricto valen 1
+};
+
+// Interpretar estricta:N o ponderada:P0,P1,... (pesos enteros positivos)
+static bool parse_class_policy(const string& text, ClassPolicy& policy) {
+    policy.weights.clear();
+    if (text.compare(0, 9, "estricta:") == 0) {
+        int classes = atoi(text.c_str() + 9);
+        if (classes < 1) {
+            return false;
+        }
+        policy.strict = true;
+        policy.weights.assign(classes, 1);
+        return true;
+    }
+    if (text.compare(0, 10, "ponderada:") != 0) {
+        return false;
+    }
+    policy.strict = false;
+    const char* cursor = text.c_str() + 10;
+    while (true) {
+        char* end = nullptr;
+        long weight = strtol(cursor, &end, 10);
+        if (end == cursor || weight < 1) {
+            return false;
+        }
+        policy.weights.push_back((int)weight);
+        if (*end == '\0') {
+            return true;
+        }
+        if (*end != ',') {
+            return false;
+        }
+        cursor = end + 1;
+    }
+}
+
+// Monitor con un anillo por clase de prioridad (-cola prioridad): enqueue deja el item en el
+// anillo de su clase y dequeue elige la clase según la política, así los items urgentes no
+// esperan detrás de los masivos. Todos los anillos comparten el mutex y la variable de
+// condición, de modo que un consumidor despierta con items de cualquier clase. Cada clase es
+// un anillo segmentado como el del monitor: crece y se achica sin mover items, así que los
+// productores no se bloquean y una ráfaga de una clase no deja memoria retenida.
+class PriorityQueueMonitor {
+private:
+    vector<unique_ptr<SegmentedRing<Item>>> rings;
+    ClassPolicy policy;
+    size_t current;       // Clase en turno (modo ponderado)
+    int credit;           // Items que la clase en turno aún puede entregar
+    size_t count;         // Items en todos los anillos
+
+    mutex mtx;
+    condition_variable not_empty;
+
+    // Agregar un item al anillo de su clase (con el mutex tomado); las clases fuera de rango
+    // van a la menos urgente
+    void push_back(const Item& item) {
+        size_t cls = min((size_t)max(item.priority, 0), rings.size() - 1);
+        rings[cls]->emplace_back(item);
+        ++count;
+    }
+
+    // Elegir la clase de la que se extrae (con el mutex tomado y count > 0)
+    size_t pick_class() {
+        if (policy.strict) {
+            size_t cls = 0;
+            while (rings[cls]->size() == 0) {
+                ++cls;
+            }
+            return cls;
+        }
+        // Turno ponderado: la clase en turno sigue mientras tenga crédito e items; una
+        // clase vacía pierde su turno y el crédito se renueva al pasar a la siguiente
+        while (credit == 0 || rings[current]->size() == 0) {
+            current = (current + 1) % rings.size();
+            credit = policy.weights[current];
+        }
+        --credit;
+        return current;
+    }
+
+    void pop_front_locked(Item& item) {
+        rings[pick_class()]->pop_front(item);
+        --count;
+    }
+
+    bool wait_for_items(unique_lock<mutex>& lock, const chrono::steady_clock::time_point* deadline) {
+        while (count == 0 && !producers_done) {
+            if (deadline == nullptr) {
+                not_empty.wait(lock);
+            } else if (not_empty.wait_until(lock, *deadline) == cv_status::timeout) {
+                break;
+            }
+        }
+        return count > 0;
+    }
+
+    bool pop_front(Item& item, const chrono::steady_clock::time_point* deadline) {
+        unique_lock<mutex> lock(mtx);
+        if (!wait_for_items(lock, deadline)) {
+            return false;
+        }
+        pop_front_locked(item);
+        return true;
+    }
+
+    size_t pop_front_bulk(Item* items, size_t max_items, const chrono::steady_clock::time_point* deadline) {
+        unique_lock<mutex> lock(mtx);
+        if (!wait_for_items(lock, deadline)) {
+            return 0;
+        }
+        size_t taken = min(max_items, count);
+        for (size_t k = 0; k < taken; ++k) {
+            pop_front_locked(items[k]);
+        }
+        return taken;
+    }
+
+public:
+    bool producers_done = false; // Indica si los productores han terminado
+
+    // Cada anillo empieza con la capacidad inicial de la cola
+    PriorityQueueMonitor(size_t init_capacity, const ClassPolicy& class_policy, AsyncLogger& logger_ref)
+        : policy(class_policy), current(0), credit(class_policy.weights[0]), count(0) {
+        for (size_t cls = 0; cls < class_policy.weights.size(); ++cls) {
+            rings.emplace_back(new SegmentedRing<Item>(init_capacity, logger_ref,
+                                                       "Un anillo de la cola con prioridades cambió de tamaño a "));
+        }
+    }
+
+    bool enqueue(const Item& item) {
+        lock_guard<mutex> lock(mtx);
+        push_back(item);
+        not_empty.notify_one();
+        return true;
+    }
+
+    size_t enqueue_bulk(const Item* items, size_t n) {
+        if (n == 0) {
+            return 0;
+        }
+        lock_guard<mutex> lock(mtx);
+        for (size_t k = 0; k < n; ++k) {
+            push_back(items[k]);
+        }
+        not_empty.notify_all();
+        return n;
+    }
+
+    bool dequeue(Item& item) {
+        return pop_front(item, nullptr);
+    }
+
+    bool dequeue_for(Item& item, chrono::steady_clock::duration timeout) {
+        return dequeue_until(item, chrono::steady_clock::now() + timeout);
+    }
+
+    bool dequeue_until(Item& item, chrono::steady_clock::time_point deadline) {
+        return pop_front(item, &deadline);
+    }
+
+    // Cada item del lote se elige con la política, así un lote no se salta las prioridades
+    size_t dequeue_bulk(Item* items, size_t max_items) {
+        return pop_front_bulk(items, max_items, nullptr);
+    }
+
+    size_t dequeue_bulk_until(Item* items, size_t max_items, chrono::steady_clock::time_point deadline) {
+        return pop_front_bulk(items, max_items, &deadline);
+    }
+
+    PriorityQueueMonitor& consumer(int) {
+        return *this;
+    }
+
+    // Items y capacidad sumados sobre todas las clases
+    void occupancy(size_t& items, size_t& current_capacity) {
+        lock_guard<mutex> lock(mtx);
+        items = count;
+        current_capacity = 0;
+        for (const unique_ptr<SegmentedRing<Item>>& ring : rings) {
+            current_capacity += ring->current_capacity();
+        }
+    }
+
+    void set_producers_done() {
+        lock_guard<mutex> lock(mtx);
+        producers_done = true;
+        not_empty.notify_all();
+    }
+};
+
+// Cola MPMC acotada sin bloqueo (Vyukov): cada casilla lleva un número de secuencia que
+// indica si está libre para el productor o lista para el consumidor del turno actual, así
+// productores y consumidores solo compiten por un CAS sobre su propio índice. Los índices
+// van en líneas de caché separadas. La capacidad es fija (potencia de dos, sin cambio de
+// tamaño); solo cuando la cola está llena o vacía se cae a esperar en una variable de
+// condición, y quien opera solo toma el mutex si hay hilos esperando.
+class LockFreeQueue {
+private:
+    static const int SPIN_LIMIT = 64;  // Reintentos antes de bloquearse
+
+    struct Slot {
+        atomic<size_t> sequence;
+        Item item;
+    };
+
+    vector<Slot> slots;
+    size_t mask;                                  // Capacidad - 1
+    alignas(64) atomic<size_t> enqueue_pos;       // Próxima casilla a escribir
+    alignas(64) atomic<size_t> dequeue_pos;       // Próxima casilla a leer
+    alignas(64) atomic<int> waiting_producers;    // Hilos dormidos por cola llena
+    atomic<int> waiting_consumers;                // Hilos dormidos por cola vacía
+    atomic<int> active_consumers;                 // Consumidores que aún no terminaron
+
+    mutex mtx;                    // Solo para dormir y despertar, no para operar
+    condition_variable not_full;
+    condition_variable not_empty;
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t capacity = 2;
+        while (capacity < n) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    // Despertar a quien espera en cond si el contador indica que hay alguien
+    void wake(atomic<int>& waiting, condition_variable& cond) {
+        atomic_thread_fence(memory_order_seq_cst);  // La operación se ve antes de leer waiting
+        if (waiting.load(memory_order_relaxed) > 0) {
+            lock_guard<mutex> lock(mtx);
+            cond.notify_all();
+        }
+    }
+
+    // Registrar que un consumidor terminó; el último despierta a los productores dormidos
+    // para que dejen de esperar casillas que nadie va a liberar
+    void consumer_left() {
+        if (active_consumers.fetch_sub(1) == 1) {
+            consumers_done.store(true);
+            lock_guard<mutex> lock(mtx);
+            not_full.notify_all();
+        }
+    }
+
+public:
+    atomic<bool> producers_done; // Indica si los productores han terminado
+    atomic<bool> consumers_done; // Indica si todos los consumidores han terminado
+
+    LockFreeQueue(size_t min_capacity, AsyncLogger& logger)
+        : slots(roundUpPowerOfTwo(min_capacity)), mask(slots.size() - 1), enqueue_pos(0), dequeue_pos(0),
+          waiting_producers(0), waiting_consumers(0), active_consumers(0), producers_done(false),
+          consumers_done(false) {
+        for (size_t i = 0; i < slots.size(); ++i) {
+            slots[i].sequence.store(i, memory_order_relaxed);
+        }
+        logger.log("Cola sin bloqueo de capacidad fija ", (long long)slots.size());
+    }
+
+    // Intentar agregar un elemento; false si la cola está llena
+    bool try_enqueue(const Item& item) {
+        size_t pos = enqueue_pos.load(memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[pos & mask];
+            size_t sequence = slot->sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // La casilla aún no la libera el consumidor de la vuelta anterior
+            } else {
+                pos = enqueue_pos.load(memory_order_relaxed);
+            }
+        }
+        slot->item = item;
+        slot->sequence.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    // Intentar extraer un elemento; false si la cola está vacía
+    bool try_dequeue(Item& item) {
+        size_t pos = dequeue_pos.load(memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[pos & mask];
+            size_t sequence = slot->sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // El productor de esta casilla todavía no escribe
+            } else {
+                pos = dequeue_pos.load(memory_order_relaxed);
+            }
+        }
+        item = slot->item;
+        slot->sequence.store(pos + mask + 1, memory_order_release);
+        return true;
+    }
+
+    // Agregar un elemento esperando mientras la cola esté llena, sin despertar consumidores;
+    // false si la cola está llena y ya no quedan consumidores que liberen casillas
+    bool push(const Item& item) {
+        for (int spins = 0; !try_enqueue(item); ++spins) {
+            if (consumers_done.load()) {
+                return false;
+            }
+            if (spins < SPIN_LIMIT) {
+                this_thread::yield();
+                continue;
+            }
+            // Antes de dormir, despertar a los consumidores por lo que ya se agregó del lote
+            wake(waiting_consumers, not_empty);
+            unique_lock<mutex> lock(mtx);
+            waiting_producers.fetch_add(1);
+            // Reintentar con el contador ya publicado: un consumidor que libere una casilla
+            // después de esto verá al productor esperando y lo despertará. consumers_done se
+            // lee con el mutex tomado, así que el aviso del último consumidor no se pierde.
+            bool done = try_enqueue(item);
+            bool abandoned = !done && consumers_done.load();
+            if (!done && !abandoned) {
+                not_full.wait(lock);
+            }
+            waiting_producers.fetch_sub(1);
+            if (abandoned) {
+                return false;
+            }
+            if (done) {
+                break;
+            }
+            spins = 0;
+        }
+        return true;
+    }
+
+    // Extraer un elemento esperando mientras la cola esté vacía y los productores no hayan
+    // terminado (o hasta deadline si se indica), sin despertar productores; false si ya no
+    // quedan elementos o venció el plazo, y en ese caso el consumidor se da por terminado
+    bool pop(Item& item, const chrono::steady_clock::time_point* deadline) {
+        for (int spins = 0; !try_dequeue(item); ++spins) {
+            if (spins < SPIN_LIMIT) {
+                this_thread::yield();
+                continue;
+            }
+            unique_lock<mutex> lock(mtx);
+            waiting_consumers.fetch_add(1);
+            bool done = try_dequeue(item);
+            bool finished = !done && producers_done.load();
+            bool expired = false;
+            if (!done && !finished) {
+                if (deadline == nullptr) {
+                    not_empty.wait(lock);
+                } else {
+                    expired = not_empty.wait_until(lock, *deadline) == cv_status::timeout;
+                }
+            }
+            waiting_consumers.fetch_sub(1);
+            lock.unlock(); // consumer_left toma el mutex
+            if (finished) {
+                consumer_left();
+                return false;
+            }
+            if (done) {
+                break;
+            }
+            if (expired) {
+                // Último intento al vencer el plazo
+                if (try_dequeue(item)) {
+                    return true;
+                }
+                consumer_left();
+                return false;
+            }
+            spins = 0;
+        }
+        return true;
+    }
+
+    // Agregar un elemento, esperando mientras la cola esté llena; false si se descartó
+    // porque todos los consumidores ya terminaron
+    bool enqueue(const Item& item) {
+        bool added = push(item);
+        wake(waiting_consumers, not_empty);
+        return added;
+    }
+
+    // Extraer un elemento; false si la cola está vacía y los productores han terminado
+    bool dequeue(Item& item) {
+        if (!pop(item, nullptr)) {
+            return false;
+        }
+        wake(waiting_producers, not_full);
+        return true;
+    }
+
+    // Extraer un elemento esperando a lo sumo timeout; false si venció el plazo o si la
+    // cola está vacía y los productores han terminado
+    bool dequeue_for(Item& item, chrono::steady_clock::duration timeout) {
+        return dequeue_until(item, chrono::steady_clock::now() + timeout);
+    }
+
+    bool dequeue_until(Item& item, chrono::steady_clock::time_point deadline) {
+        if (!pop(item, &deadline)) {
+            return false;
+        }
+        wake(waiting_producers, not_full);
+        return true;
+    }
+
+    // Agregar n elementos con una sola notificación al final; devuelve cuántos se agregaron
+    // (menos de n si los consumidores terminaron antes)
+    size_t enqueue_bulk(const Item* items, size_t n) {
+        size_t added = 0;
+        while (added < n && push(items[added])) {
+            ++added;
+        }
+        wake(waiting_consumers, not_empty);
+        return added;
+    }
+
+    // Extraer hasta max_items elementos: espera solo por el primero y toma los demás que
+    // ya estén disponibles; 0 si la cola está vacía y los productores han terminado
+    size_t dequeue_bulk(Item* items, size_t max_items) {
+        return pop_bulk(items, max_items, nullptr);
+    }
+
+    // Como dequeue_bulk, pero esperando el primero a lo sumo hasta deadline
+    size_t dequeue_bulk_until(Item* items, size_t max_items, chrono::steady_clock::time_point deadline) {
+        return pop_bulk(items, max_items, &deadline);
+    }
+
+private:
+    size_t pop_bulk(Item* items, size_t max_items, const chrono::steady_clock::time_point* deadline) {
+        if (max_items == 0 || !pop(items[0], deadline)) {
+            return 0;
+        }
+        size_t taken = 1;
+        while (taken < max_items && try_dequeue(items[taken])) {
+            ++taken;
+        }
+        wake(waiting_producers, not_full);
+        return taken;
+    }
+
+public:
+    // Vista de la cola para el consumidor consumer_id (la cola es compartida por todos).
+    // Cada consumidor la pide una vez al empezar, lo que permite saber cuándo terminó el último.
+    LockFreeQueue& consumer(int) {
+        active_consumers.fetch_add(1);
+        return *this;
+    }
+
+    // Elementos y capacidad actuales (aproximado: los índices se leen sin detener la cola)
+    void occupancy(size_t& items, size_t& current_capacity) {
+        size_t dequeued = dequeue_pos.load(memory_order_relaxed);
+        size_t enqueued = enqueue_pos.load(memory_order_relaxed);
+        items = enqueued > dequeued ? min(enqueued - dequeued, slots.size()) : 0;
+        current_capacity = slots.size();
+    }
+
+    // Función para indicar que los productores han terminado
+    void set_producers_done() {
+        producers_done.store(true);
+        lock_guard<mutex> lock(mtx);
+        not_empty.notify_all();
+    }
+};
+
+// Deque de Chase-Lev: el dueño agrega y saca por abajo sin bloqueo y los demás hilos roban
+// por arriba con un CAS sobre top. Solo el dueño hace crecer el arreglo; los arreglos
+// anteriores se conservan hasta destruir el deque porque un ladrón puede estar leyéndolos.
+// Cada casilla guarda los campos del Item en atómicos relajados: una lectura que compite
+// con una escritura se descarta porque el CAS del ladrón falla.
+class WorkStealingDeque {
+private:
+    struct Array {
+        size_t size;
+        unique_ptr<atomic<int>[]> values;
+        unique_ptr<atomic<int>[]> nodes;
+        unique_ptr<atomic<int>[]> priorities;
+        unique_ptr<atomic<long long>[]> stamps;
+        unique_ptr<atomic<char*>[]> payloads;
+
+        // Las casillas se escriben al crear el arreglo, así sus páginas se asignan en el nodo
+        // del hilo que lo crea (-nodo-cola para el inicial, el dueño para los que crecen)
+        Array(size_t n)
+            : size(n), values(new atomic<int>[n]), nodes(new atomic<int>[n]),
+              priorities(new atomic<int>[n]), stamps(new atomic<long long>[n]), payloads(new atomic<char*>[n]) {
+            for (size_t i = 0; i < n; ++i) {
+                values[i].store(0, memory_order_relaxed);
+                nodes[i].store(0, memory_order_relaxed);
+                priorities[i].store(0, memory_order_relaxed);
+                stamps[i].store(0, memory_order_relaxed);
+                payloads[i].store(nullptr, memory_order_relaxed);
+            }
+        }
+
+        void put(long long i, const Item& item) {
+            values[i & (size - 1)].store(item.value, memory_order_relaxed);
+            nodes[i & (size - 1)].store(item.node, memory_order_relaxed);
+            priorities[i & (size - 1)].store(item.priority, memory_order_relaxed);
+            stamps[i & (size - 1)].store(item.produced_ns, memory_order_relaxed);
+            payloads[i & (size - 1)].store(item.payload, memory_order_relaxed);
+        }
+        Item get(long long i) const {
+            Item item = {values[i & (size - 1)].load(memory_order_relaxed),
+                         nodes[i & (size - 1)].load(memory_order_relaxed),
+                         priorities[i & (size - 1)].load(memory_order_relaxed),
+                         stamps[i & (size - 1)].load(memory_order_relaxed),
+                         payloads[i & (size - 1)].load(memory_order_relaxed)};
+            return item;
+        }
+    };
+
+    atomic<long long> top;                  // Próximo a robar
+    char padding[64];                       // top y bottom en líneas de caché distintas (sin alignas:
+                                            // el deque se crea con new y C++11 no alinea a 64)
+    atomic<long long> bottom;               // Próxima casilla libre del dueño
+    atomic<Array*> array;
+    vector<unique_ptr<Array>> arrays;       // Actual y anteriores (solo las toca el dueño)
 
-    // Función para redimensionar la cola
-    void resize(size_t new_capacity) {
-        vector<int> new_buffer(new_capacity); // Crear un nuevo buffer con la nueva capacidad
+public:
+    WorkStealingDeque(size_t capacity) : top(0), bottom(0) {
+        arrays.emplace_back(new Array(capacity));
+        array.store(arrays.back().get(), memory_order_relaxed);
+    }
 
-        // Copiar los elementos del buffer antiguo al nuevo
-        for (size_t i = 0; i < count; ++i) {
-            new_buffer[i] = buffer[(front + i) % capacity];
+    // Dueño: agregar abajo; true si hubo que duplicar el arreglo
+    bool push(const Item& item) {
+        long long b = bottom.load(memory_order_relaxed);
+        long long t = top.load(memory_order_acquire);
+        Array* a = array.load(memory_order_relaxed);
+        bool grew = false;
+        if (b - t > (long long)a->size - 1) {
+            Array* bigger = new Array(a->size * 2);
+            for (long long i = t; i < b; ++i) {
+                bigger->put(i, a->get(i));
+            }
+            arrays.emplace_back(bigger);
+            array.store(bigger, memory_order_release);
+            a = bigger;
+            grew = true;
         }
+        a->put(b, item);
+        atomic_thread_fence(memory_order_release);
+        bottom.store(b + 1, memory_order_relaxed);
+        return grew;
+    }
 
-        buffer = move(new_buffer); // Reemplazar el buffer antiguo por el nuevo
-        capacity = new_capacity;   // Actualizar la capacidad
-        front = 0;                 // Reiniciar el índice del frente
-        rear = count % capacity;   // Actualizar el índice del final
+    // Dueño: sacar de abajo (el último agregado); false si está vacío
+    bool take(Item& item) {
+        long long b = bottom.load(memory_order_relaxed) - 1;
+        Array* a = array.load(memory_order_relaxed);
+        bottom.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        long long t = top.load(memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, memory_order_relaxed); // Estaba vacío
+            return false;
+        }
+        item = a->get(b);
+        if (t == b) {
+            // Último elemento: se compite con los ladrones por él
+            bool won = top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+            bottom.store(b + 1, memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
 
-        // Registrar en el log el cambio de tamaño
-        log_file << "La cola cambió de tamaño a " << capacity << endl;
+    // Otro hilo: robar de arriba (el más antiguo); false si está vacío o perdió la carrera
+    bool steal(Item& item) {
+        long long t = top.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        long long b = bottom.load(memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        Array* a = array.load(memory_order_acquire);
+        item = a->get(t);
+        return top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
     }
 
-public:
-    bool producers_done = false; // Indica si los productores han terminado
+    size_t size() const {
+        long long n = bottom.load(memory_order_relaxed) - top.load(memory_order_relaxed);
+        return n > 0 ? (size_t)n : 0;
+    }
 
-    // Constructor de la clase
-    CircularQueueMonitor(size_t init_capacity, ofstream& log_file_ref)
-        : capacity(init_capacity), front(0), rear(0), count(0), buffer(init_capacity), log_file(log_file_ref) {}
+    size_t capacity() const {
+        return array.load(memory_order_acquire)->size; // Otro hilo (el muestreo) puede leerla
+    }
+};
 
-    // Función para agregar un elemento a la cola
-    void enqueue(int item) {
-        unique_lock<mutex> lock(mtx); // Adquirir el mutex
+// Topología con robo de trabajo: cada consumidor tiene su propio deque de Chase-Lev en vez
+// de una cola central. Como el deque solo admite un escritor, los productores dejan los
+// items en el buzón del consumidor elegido (por turno o por hash del valor) y el dueño los
+// pasa a su deque. Un consumidor sin trabajo roba de los deques y buzones de los demás, y
+// solo se duerme cuando no hay items pendientes en ningún lado.
+class WorkStealingQueue {
+private:
+    struct Worker {
+        WorkStealingDeque deque;
+        mutex inbox_mtx;
+        vector<Item> inbox;       // Items entregados por los productores, aún fuera del deque
+        vector<Item> drained;     // Buffer del dueño para vaciar el buzón sin copiar bajo el mutex
 
-        // Esperar mientras la cola esté llena
-        not_full.wait(lock, [this]() { return count < capacity; });
+        // Los buzones empiezan con la capacidad del deque ya escrita (resize y clear conservan
+        // la reserva), por la misma razón que las casillas del deque
+        Worker(size_t capacity) : deque(capacity) {
+            inbox.resize(capacity);
+            inbox.clear();
+            drained.resize(capacity);
+            drained.clear();
+        }
+    };
 
-        // Agregar el elemento al final de la cola
-        buffer[rear] = item;
-        rear = (rear + 1) % capacity; // Actualizar el índice del final
-        ++count;                      // Incrementar el contador de elementos
+    vector<unique_ptr<Worker>> workers;
+    bool hash_distribution;
+    AsyncLogger& logger;
+    alignas(64) atomic<size_t> next_worker;    // Turno para el reparto round-robin
+    alignas(64) atomic<long long> pending;     // Items entregados y aún no extraídos
+    atomic<int> sleeping;                      // Consumidores dormidos
 
-        // Si la cola está llena después de agregar, duplicar su tamaño
-        if (count == capacity) {
-            resize(capacity * 2);
+    mutex idle_mtx;               // Solo para dormir y despertar consumidores
+    condition_variable idle;
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t capacity = 2;
+        while (capacity < n) {
+            capacity <<= 1;
         }
+        return capacity;
+    }
 
-        not_empty.notify_one(); // Notificar a un hilo que espera por elementos
+    size_t target_for(const Item& item) {
+        if (hash_distribution) {
+            uint32_t h = (uint32_t)item.value * 2654435761u; // Hash multiplicativo de Knuth
+            return h % workers.size();
+        }
+        return next_worker.fetch_add(1, memory_order_relaxed) % workers.size();
     }
 
-    // Función para extraer un elemento de la cola
-    bool dequeue(int& item) {
-        unique_lock<mutex> lock(mtx); // Adquirir el mutex
+    // Despertar consumidores dormidos si los hay (el aumento de pending ya es visible)
+    void wake() {
+        if (sleeping.load() > 0) {
+            lock_guard<mutex> lock(idle_mtx);
+            idle.notify_all();
+        }
+    }
 
-        // Esperar mientras la cola esté vacía y los productores no hayan terminado
-        while (count == 0 && !producers_done) {
-            not_empty.wait(lock);
+    // Pasar el buzón del consumidor id a su deque; true si había items
+    bool drain_inbox(size_t id) {
+        Worker& worker = *workers[id];
+        {
+            lock_guard<mutex> lock(worker.inbox_mtx);
+            if (worker.inbox.empty()) {
+                return false;
+            }
+            swap(worker.inbox, worker.drained);
+        }
+        for (const Item& item : worker.drained) {
+            if (worker.deque.push(item)) {
+                logger.log("Deque de consumidor creció a ", (long long)worker.deque.capacity());
+            }
+        }
+        worker.drained.clear();
+        return true;
+    }
+
+    // Buscar trabajo sin bloquearse: deque propio, buzón propio y luego robar a los demás
+    bool find_work(size_t id, Item& item) {
+        Worker& own = *workers[id];
+        if (own.deque.take(item) || (drain_inbox(id) && own.deque.take(item))) {
+            return true;
+        }
+        for (size_t k = 1; k < workers.size(); ++k) {
+            Worker& victim = *workers[(id + k) % workers.size()];
+            if (victim.deque.steal(item)) {
+                return true;
+            }
+            // El dueño puede estar ocupado: llevarse su buzón entero con un swap (como en
+            // drain_inbox), quedarse con el item más antiguo y pasar el resto al deque propio,
+            // de donde los demás pueden volver a robarlos
+            {
+                lock_guard<mutex> lock(victim.inbox_mtx);
+                if (victim.inbox.empty()) {
+                    continue;
+                }
+                swap(victim.inbox, own.drained);
+            }
+            item = own.drained.front();
+            for (size_t i = 1; i < own.drained.size(); ++i) {
+                if (own.deque.push(own.drained[i])) {
+                    logger.log("Deque de consumidor creció a ", (long long)own.deque.capacity());
+                }
+            }
+            own.drained.clear();
+            return true;
         }
+        return false;
+    }
 
-        // Si la cola sigue vacía y los productores han terminado, no hay más elementos
-        if (count == 0 && producers_done) {
-            return false;
+    bool pop(size_t id, Item& item, const chrono::steady_clock::time_point* deadline) {
+        while (true) {
+            if (find_work(id, item)) {
+                pending.fetch_sub(1);
+                return true;
+            }
+            if (pending.load() > 0) {
+                this_thread::yield(); // Hay items en tránsito (un robo o un vaciado en curso)
+                continue;
+            }
+            unique_lock<mutex> lock(idle_mtx);
+            sleeping.fetch_add(1);
+            // Con sleeping publicado, un productor que agregue después nos despertará
+            bool finished = false;
+            bool expired = false;
+            if (pending.load() == 0) {
+                finished = producers_done.load();
+                if (!finished) {
+                    if (deadline == nullptr) {
+                        idle.wait(lock);
+                    } else {
+                        expired = idle.wait_until(lock, *deadline) == cv_status::timeout;
+                    }
+                }
+            }
+            sleeping.fetch_sub(1);
+            if (finished) {
+                return false;
+            }
+            if (expired) {
+                lock.unlock();
+                if (find_work(id, item)) {
+                    pending.fetch_sub(1);
+                    return true;
+                }
+                return false;
+            }
+        }
+    }
+
+    size_t pop_bulk(size_t id, Item* items, size_t max_items, const chrono::steady_clock::time_point* deadline) {
+        if (max_items == 0 || !pop(id, items[0], deadline)) {
+            return 0;
         }
+        size_t taken = 1;
+        while (taken < max_items && workers[id]->deque.take(items[taken])) {
+            ++taken;
+        }
+        pending.fetch_sub((long long)(taken - 1));
+        return taken;
+    }
 
-        // Extraer el elemento del frente de la cola
-        item = buffer[front];
-        front = (front + 1) % capacity; // Actualizar el índice del frente
-        --count;                        // Decrementar el contador de elementos
+public:
+    atomic<bool> producers_done; // Indica si los productores han terminado
 
-        // Si el uso de la cola llega al 25% o menos, reducir su tamaño a la mitad
-        if (capacity > 1 && count <= capacity / 4) {
-            resize(capacity / 2);
+    // Vista de un consumidor: las extracciones usan su deque y roban a los demás
+    class Consumer {
+    private:
+        WorkStealingQueue& queue;
+        size_t id;
+
+    public:
+        Consumer(WorkStealingQueue& owner, size_t consumer_id) : queue(owner), id(consumer_id) {}
+
+        bool dequeue(Item& item) { return queue.pop(id, item, nullptr); }
+        bool dequeue_until(Item& item, chrono::steady_clock::time_point deadline) {
+            return queue.pop(id, item, &deadline);
         }
+        size_t dequeue_bulk(Item* items, size_t max_items) { return queue.pop_bulk(id, items, max_items, nullptr); }
+        size_t dequeue_bulk_until(Item* items, size_t max_items, chrono::steady_clock::time_point deadline) {
+            return queue.pop_bulk(id, items, max_items, &deadline);
+        }
+    };
 
-        not_full.notify_one(); // Notificar a un hilo que espera por espacio
+    WorkStealingQueue(size_t num_consumers, size_t initial_capacity, bool hash, AsyncLogger& logger_ref)
+        : hash_distribution(hash), logger(logger_ref), next_worker(0), pending(0), sleeping(0),
+          producers_done(false) {
+        for (size_t i = 0; i < max(num_consumers, (size_t)1); ++i) {
+            workers.emplace_back(new Worker(roundUpPowerOfTwo(initial_capacity)));
+        }
+    }
+
+    Consumer consumer(int consumer_id) {
+        return Consumer(*this, (size_t)consumer_id % workers.size());
+    }
+
+    // Entregar un item al buzón del consumidor elegido
+    bool enqueue(const Item& item) {
+        Worker& worker = *workers[target_for(item)];
+        {
+            lock_guard<mutex> lock(worker.inbox_mtx);
+            worker.inbox.push_back(item);
+        }
+        pending.fetch_add(1);
+        wake();
         return true;
     }
 
+    // Entregar un lote completo a un mismo consumidor, con un solo despertar
+    size_t enqueue_bulk(const Item* items, size_t n) {
+        if (n == 0) {
+            return 0;
+        }
+        Worker& worker = *workers[target_for(items[0])];
+        {
+            lock_guard<mutex> lock(worker.inbox_mtx);
+            worker.inbox.insert(worker.inbox.end(), items, items + n);
+        }
+        pending.fetch_add((long long)n);
+        wake();
+        return n;
+    }
+
+    // Items pendientes y capacidad sumada de los deques (aproximado)
+    void occupancy(size_t& items, size_t& current_capacity) {
+        long long queued = pending.load(memory_order_relaxed);
+        items = queued > 0 ? (size_t)queued : 0;
+        current_capacity = 0;
+        for (const auto& worker : workers) {
+            current_capacity += worker->deque.capacity();
+        }
+    }
+
     // Función para indicar que los productores han terminado
     void set_producers_done() {
-        unique_lock<mutex> lock(mtx); // Adquirir el mutex
-        producers_done = true;        // Marcar que los productores han terminado
-        not_empty.notify_all();       // Notificar a todos los hilos que esperan por elementos
+        producers_done.store(true);
+        lock_guard<mutex> lock(idle_mtx);
+        idle.notify_all();
+    }
+};
+
+// Histograma de latencias al estilo HDR: 32 casillas lineales por cada potencia de dos,
+// así cualquier valor queda con un error relativo menor al 3% usando memoria fija
+// (1920 contadores) y registrar es O(1) sin asignaciones.
+class LatencyHistogram {
+private:
+    static const int SUB_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int BUCKETS = (64 - SUB_BITS) * SUB_BUCKETS;
+
+    vector<long long> counts;
+    long long total;
+    long long sum;
+    long long maximum;
+
+    static int bucket_of(unsigned long long value) {
+        if (value < (unsigned long long)(2 * SUB_BUCKETS)) {
+            return (int)value;
+        }
+        int magnitude = 63 - __builtin_clzll(value);
+        int shift = magnitude - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + (int)((value >> shift) - SUB_BUCKETS);
+    }
+
+    // Mayor valor que cae en la casilla
+    static long long bucket_top(int bucket) {
+        if (bucket < 2 * SUB_BUCKETS) {
+            return bucket;
+        }
+        int shift = bucket / SUB_BUCKETS - 1;
+        long long low = (long long)(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+        return low + (1LL << shift) - 1;
+    }
+
+public:
+    LatencyHistogram() : counts(BUCKETS, 0), total(0), sum(0), maximum(0) {}
+
+    void record(long long nanoseconds) {
+        nanoseconds = max(nanoseconds, 0LL);
+        counts[bucket_of((unsigned long long)nanoseconds)]++;
+        total++;
+        sum += nanoseconds;
+        maximum = max(maximum, nanoseconds);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < BUCKETS; ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        maximum = max(maximum, other.maximum);
+    }
+
+    long long samples() const { return total; }
+    long long max_value() const { return maximum; }
+    double mean() const { return total > 0 ? (double)sum / total : 0.0; }
+
+    // Valor bajo el cual queda la fracción p de las muestras
+    long long percentile(double p) const {
+        long long rank = (long long)(p * total + 0.5);
+        long long seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank && seen > 0) {
+                return min(bucket_top(i), maximum);
+            }
+        }
+        return 0;
+    }
+};
+
+// Contadores de un hilo; cada hilo escribe solo los suyos y se juntan al final
+struct ThreadStats {
+    long long items;
+    long long checksum;        // Suma de los bytes de carga leídos (para que la lectura no se elimine)
+    LatencyHistogram wait;     // Espera dentro de enqueue o dequeue (bloqueo incluido)
+    LatencyHistogram latency;  // Consumidores: desde que se produjo el item hasta que se extrajo
+    long long remote_items;    // Consumidores: items producidos en otro nodo NUMA
+    LatencyHistogram remote_latency; // Latencia de extremo a extremo de esos items
+    vector<LatencyHistogram> class_latency; // Latencia de extremo a extremo por clase de prioridad
+
+    ThreadStats() : items(0), checksum(0), remote_items(0) {}
+};
+
+// Muestra periódica de la ocupación de la cola
+struct OccupancySample {
+    double seconds;
+    size_t items;
+    size_t capacity;
+};
+
+// Tiempo de servicio por item: pausa fija, pausa exponencial con la media dada, trabajo de
+// CPU (girar durante N ns sin soltar el núcleo) o nada. Con "cero" el simulador mide solo
+// el costo de la cola.
+struct ServiceTime {
+    enum Kind { ZERO, FIXED, EXPONENTIAL, SPIN } kind;
+    long long nanoseconds;  // Duración (o media, para EXPONENTIAL)
+
+    template <typename Generator>
+    void apply(Generator& rng) const {
+        switch (kind) {
+        case ZERO:
+            break;
+        case FIXED:
+            this_thread::sleep_for(chrono::nanoseconds(nanoseconds));
+            break;
+        case EXPONENTIAL: {
+            exponential_distribution<double> service(1.0 / nanoseconds);
+            this_thread::sleep_for(chrono::nanoseconds((long long)service(rng)));
+            break;
+        }
+        case SPIN: {
+            long long until = now_ns() + nanoseconds;
+            while (now_ns() < until) {
+            }
+            break;
+        }
+        }
+    }
+};
+
+// Interpretar cero, fijo:DURACIÓN, exp:DURACIÓN o giro:DURACIÓN, con DURACIÓN en ns, us,
+// ms o s (por ejemplo fijo:10ms, giro:500ns)
+bool parse_service_time(const string& text, ServiceTime& service) {
+    if (text == "cero") {
+        service.kind = ServiceTime::ZERO;
+        service.nanoseconds = 0;
+        return true;
+    }
+    size_t colon = text.find(':');
+    if (colon == string::npos) {
+        return false;
     }
+    string kind = text.substr(0, colon);
+    if (kind == "fijo") {
+        service.kind = ServiceTime::FIXED;
+    } else if (kind == "exp") {
+        service.kind = ServiceTime::EXPONENTIAL;
+    } else if (kind == "giro") {
+        service.kind = ServiceTime::SPIN;
+    } else {
+        return false;
+    }
+    char* unit = nullptr;
+    double amount = strtod(text.c_str() + colon + 1, &unit);
+    double scale;
+    if (strcmp(unit, "ns") == 0) {
+        scale = 1;
+    } else if (strcmp(unit, "us") == 0) {
+        scale = 1e3;
+    } else if (strcmp(unit, "ms") == 0) {
+        scale = 1e6;
+    } else if (strcmp(unit, "s") == 0) {
+        scale = 1e9;
+    } else {
+        return false;
+    }
+    service.nanoseconds = (long long)(amount * scale);
+    return amount > 0 && service.nanoseconds > 0;
+}
+
+// Carga de trabajo de la simulación (-tp, -tc, -items, -carga)
+struct Workload {
+    ServiceTime produce;     // Trabajo del productor por item
+    ServiceTime consume;     // Trabajo del consumidor por item
+    int items_per_producer;
+    size_t payload_size;     // Bytes de carga por item (0 = sin carga)
+    PayloadPool* pool;       // Arena para las cargas, o nullptr para usar new/delete
+    vector<double> class_mix; // Proporción de items de cada clase (-mezcla); vacía = todos clase 0
 };
 
-// Función que ejecuta cada hilo productor
-void producer_function(CircularQueueMonitor& queue_monitor, int producer_id, int items_to_produce) {
+// Liberar la carga de un item que no llegó a la cola
+void discard_payload(Item& item, const Workload& workload) {
+    if (item.payload == nullptr) {
+        return;
+    }
+    if (workload.pool != nullptr) {
+        workload.pool->release(item.payload);
+    } else {
+        delete[] item.payload;
+    }
+    item.payload = nullptr;
+}
+
+// Función que ejecuta cada hilo productor.
+// Con batch_size > 1 los items se juntan y se agregan por lotes con enqueue_bulk.
+// Si la cola rechaza items (la cola sin bloqueo, cuando ya no quedan consumidores) el
+// productor descarta su carga y termina, y en stats.items cuenta solo los entregados.
+template <typename Queue>
+void producer_function(Queue& queue_monitor, int producer_id, const Workload& workload, size_t batch_size,
+                       ThreadStats& stats) {
+    int items_to_produce = workload.items_per_producer;
+    mt19937_64 rng(producer_id + 1);
+    discrete_distribution<int> class_of(workload.class_mix.begin(), workload.class_mix.end());
+    vector<Item> batch;
+    batch.reserve(batch_size);
     for (int i = 0; i < items_to_produce; ++i) {
-        queue_monitor.enqueue(i); // Agregar un item a la cola
-        // Simular trabajo con una pausa
-        this_thread::sleep_for(chrono::milliseconds(10));
+        Item item = {i, current_node(), workload.class_mix.size() > 1 ? class_of(rng) : 0, 0, nullptr};
+        if (workload.payload_size > 0) {
+            item.payload = workload.pool != nullptr ? workload.pool->allocate() : new char[workload.payload_size];
+            memset(item.payload, i & 0xff, workload.payload_size);
+        }
+        long long start = now_ns();
+        item.produced_ns = start;
+        if (batch_size <= 1) {
+            bool added = queue_monitor.enqueue(item); // Agregar un item a la cola
+            stats.wait.record(now_ns() - start);
+            if (!added) {
+                discard_payload(item, workload);
+                break;
+            }
+        } else {
+            batch.push_back(item);
+            if (batch.size() == batch_size || i + 1 == items_to_produce) {
+                // Agregar el lote completo
+                size_t added = queue_monitor.enqueue_bulk(batch.data(), batch.size());
+                stats.wait.record(now_ns() - start);
+                if (added < batch.size()) {
+                    for (size_t k = added; k < batch.size(); ++k) {
+                        discard_payload(batch[k], workload);
+                    }
+                    // Descontar los items del lote que ya se habían contado y no se entregaron
+                    stats.items -= (long long)(batch.size() - added - 1);
+                    break;
+                }
+                batch.clear();
+            }
+        }
+        stats.items++;
+        // Simular trabajo según el modelo de carga
+        workload.produce.apply(rng);
     }
 }
 
-// Función que ejecuta cada hilo consumidor
-void consumer_function(CircularQueueMonitor& queue_monitor, int consumer_id, int max_wait_time) {
+// Función que ejecuta cada hilo consumidor.
+// Con batch_size > 1 se extraen hasta batch_size items por vez con dequeue_bulk.
+// La espera máxima se cumple dentro de la cola con un plazo (dequeue_until): el consumidor
+// duerme hasta que llega un item o vence el plazo, sin sondear.
+template <typename Queue>
+void consumer_function(Queue& queue_monitor, int consumer_id, int max_wait_time, const Workload& workload,
+                       size_t batch_size, ThreadStats& stats) {
+    mt19937_64 rng(1000 + consumer_id);
     auto start_time = chrono::steady_clock::now(); // Tiempo de inicio
-    int item;
+    vector<Item> batch(max(batch_size, (size_t)1));
+    auto&& source = queue_monitor.consumer(consumer_id); // Con robo de trabajo, el deque propio
 
     while (true) {
-        if (queue_monitor.dequeue(item)) {
-            // Procesar el item (aquí no hacemos nada específico)
-            // Simular trabajo con una pausa
-            this_thread::sleep_for(chrono::milliseconds(15));
+        // Plazo: max_wait_time segundos desde el último item (o desde el inicio)
+        auto deadline = start_time + chrono::seconds(max_wait_time);
+        long long wait_start = now_ns();
+        size_t taken = batch_size <= 1 ? (source.dequeue_until(batch[0], deadline) ? 1 : 0)
+                                       : source.dequeue_bulk_until(batch.data(), batch_size, deadline);
+        long long received = now_ns();
+        stats.wait.record(received - wait_start);
+        int node = taken > 0 ? current_node() : 0;
+        for (size_t k = 0; k < taken; ++k) {
+            stats.latency.record(received - batch[k].produced_ns);
+            size_t cls = batch[k].priority;
+            if (cls >= stats.class_latency.size()) {
+                stats.class_latency.resize(cls + 1);
+            }
+            stats.class_latency[cls].record(received - batch[k].produced_ns);
+            if (batch[k].node != node) {
+                stats.remote_items++;
+                stats.remote_latency.record(received - batch[k].produced_ns);
+            }
+        }
+        stats.items += taken;
+        if (taken > 0) {
+            // Procesar los items: leer y liberar la carga, y simular el trabajo por item
+            for (size_t k = 0; k < taken; ++k) {
+                if (batch[k].payload != nullptr) {
+                    for (size_t b = 0; b < workload.payload_size; ++b) {
+                        stats.checksum += (unsigned char)batch[k].payload[b];
+                    }
+                    if (workload.pool != nullptr) {
+                        workload.pool->release(batch[k].payload);
+                    } else {
+                        delete[] batch[k].payload;
+                    }
+                }
+                workload.consume.apply(rng);
+            }
 
             // Reiniciar el temporizador si se obtuvo un item
             start_time = chrono::steady_clock::now();
         } else {
-            // Si no se pudo extraer un item y los productores han terminado
-            if (queue_monitor.producers_done) {
-                break; // Terminar el consumidor
+            // Los productores terminaron y la cola quedó vacía, o se excedió el tiempo
+            // máximo de espera: terminar el consumidor
+            break;
+        }
+    }
+}
+
+// Colas disponibles para -cola
+enum QueueType { QUEUE_MONITOR, QUEUE_LOCK_FREE, QUEUE_WORK_STEALING, QUEUE_PRIORITY };
+static const char* const QUEUE_TYPE_NAMES[] = {"monitor", "sin bloqueo", "robo de trabajo", "con prioridades"};
+
+// Transferir items_per_producer items por productor sin pausas y medir el tiempo total
+template <typename Queue>
+double time_transfer(Queue& queue_monitor, int num_producers, int num_consumers, int items_per_producer,
+                     size_t batch_size, int num_classes) {
+    vector<thread> producers;
+    vector<thread> consumers;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < num_producers; ++i) {
+        producers.emplace_back([&queue_monitor, items_per_producer, batch_size, num_classes]() {
+            vector<Item> batch(batch_size);
+            for (int j = 0; j < items_per_producer; j += (int)batch_size) {
+                size_t n = min(batch_size, (size_t)(items_per_producer - j));
+                for (size_t k = 0; k < n; ++k) {
+                    batch[k].value = j + (int)k;
+                    batch[k].priority = (j + (int)k) % num_classes; // Clases repartidas por turno
+                    batch[k].produced_ns = 0;
+                    batch[k].payload = nullptr;
+                }
+                if (batch_size <= 1) {
+                    queue_monitor.enqueue(batch[0]);
+                } else {
+                    queue_monitor.enqueue_bulk(batch.data(), n);
+                }
+            }
+        });
+    }
+    for (int i = 0; i < num_consumers; ++i) {
+        consumers.emplace_back([&queue_monitor, batch_size, i]() {
+            vector<Item> batch(batch_size);
+            auto&& source = queue_monitor.consumer(i);
+            if (batch_size <= 1) {
+                while (source.dequeue(batch[0])) {
+                }
+            } else {
+                while (source.dequeue_bulk(batch.data(), batch_size) > 0) {
+                }
             }
+        });
+    }
+    for (auto& prod : producers) {
+        prod.join();
+    }
+    queue_monitor.set_producers_done();
+    for (auto& cons : consumers) {
+        cons.join();
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
 
-            // Verificar si ha excedido el tiempo máximo de espera
-            auto current_time = chrono::steady_clock::now();
-            auto elapsed_time = chrono::duration_cast<chrono::seconds>(current_time - start_time).count();
+// Microbenchmark de contención: productores y consumidores sin pausas de trabajo simulado,
+// para medir solo el costo de la cola. Se repite para varias combinaciones de hilos y se
+// informan los items transferidos por segundo (cada item es un enqueue y un dequeue).
+void run_benchmark(QueueType queue_type, bool hash_distribution, const ClassPolicy& class_policy,
+                   size_t initial_queue_size, int total_items, size_t batch_size, AsyncLogger& logger) {
+    const int thread_counts[] = {1, 2, 4, 8};
 
-            if (elapsed_time >= max_wait_time) {
-                break; // Terminar el consumidor por tiempo de espera
+    cout << "Cola: " << QUEUE_TYPE_NAMES[queue_type] << ", lote: " << batch_size << endl;
+    cout << "Productores\tConsumidores\tItems\tSegundos\tItems/s" << endl;
+    for (int num_producers : thread_counts) {
+        for (int num_consumers : thread_counts) {
+            int items_per_producer = total_items / num_producers;
+            int num_classes = (int)class_policy.weights.size();
+            double seconds;
+            switch (queue_type) {
+            case QUEUE_LOCK_FREE: {
+                LockFreeQueue queue_monitor(initial_queue_size, logger);
+                seconds = time_transfer(queue_monitor, num_producers, num_consumers, items_per_producer, batch_size,
+                                        num_classes);
+                break;
+            }
+            case QUEUE_PRIORITY: {
+                PriorityQueueMonitor queue_monitor(initial_queue_size, class_policy, logger);
+                seconds = time_transfer(queue_monitor, num_producers, num_consumers, items_per_producer, batch_size,
+                                        num_classes);
+                break;
+            }
+            case QUEUE_WORK_STEALING: {
+                WorkStealingQueue queue_monitor(num_consumers, initial_queue_size, hash_distribution, logger);
+                seconds = time_transfer(queue_monitor, num_producers, num_consumers, items_per_producer, batch_size,
+                                        num_classes);
+                break;
             }
+            default: {
+                CircularQueueMonitor<Item> queue_monitor(initial_queue_size, logger);
+                seconds = time_transfer(queue_monitor, num_producers, num_consumers, items_per_producer, batch_size,
+                                        num_classes);
+                break;
+            }
+            }
+
+            long long items = (long long)items_per_producer * num_producers;
+            cout << num_producers << "\t" << num_consumers << "\t" << items << "\t" << seconds << "\t"
+                 << (long long)(seconds > 0 ? items / seconds : 0) << endl;
+        }
+    }
+}
+
+// Escribir una fila del resumen de latencias (en microsegundos)
+void print_latency_row(ostream& out, const char* name, const LatencyHistogram& histogram) {
+    out << name << "\t" << histogram.samples() << "\t" << histogram.percentile(0.50) / 1000.0 << "\t"
+        << histogram.percentile(0.90) / 1000.0 << "\t" << histogram.percentile(0.99) / 1000.0 << "\t"
+        << histogram.percentile(0.999) / 1000.0 << "\t" << histogram.max_value() / 1000.0 << endl;
+}
 
-            // Esperar un poco antes de intentar nuevamente
+// Escribir una fila del CSV de métricas
+void write_metrics_row(ostream& out, const char* role, const string& thread_id, long long items,
+                       const char* metric, const LatencyHistogram& histogram) {
+    out << role << "," << thread_id << "," << items << "," << metric << "," << histogram.samples() << ","
+        << histogram.percentile(0.50) / 1000.0 << "," << histogram.percentile(0.90) / 1000.0 << ","
+        << histogram.percentile(0.99) / 1000.0 << "," << histogram.percentile(0.999) / 1000.0 << ","
+        << histogram.max_value() / 1000.0 << "," << histogram.mean() / 1000.0 << "\n";
+}
+
+// Ejecutar la simulación de productores y consumidores sobre la cola elegida. Cada hilo
+// lleva sus propios contadores e histogramas y un hilo aparte muestrea la ocupación cada
+// 10 ms; al terminar se imprime un resumen y, si se pidió, se escriben los CSV.
+template <typename Queue>
+void run_simulation(Queue& queue_monitor, int num_producers, int num_consumers, int max_consumer_wait_time,
+                    const Workload& workload, size_t batch_size, const ThreadPlacement& producer_placement,
+                    const ThreadPlacement& consumer_placement, const string& metrics_filename) {
+    // Vectores para almacenar los hilos productores y consumidores
+    vector<thread> producers;
+    vector<thread> consumers;
+    vector<ThreadStats> producer_stats(num_producers);
+    vector<ThreadStats> consumer_stats(num_consumers);
+
+    // Muestreo de ocupación
+    vector<OccupancySample> occupancy;
+    atomic<bool> sampling(true);
+    auto start = chrono::steady_clock::now();
+    thread sampler([&]() {
+        while (sampling.load()) {
+            OccupancySample sample;
+            queue_monitor.occupancy(sample.items, sample.capacity);
+            sample.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            occupancy.push_back(sample);
             this_thread::sleep_for(chrono::milliseconds(10));
         }
+    });
+
+    // Crear los hilos productores
+    for (int i = 0; i < num_producers; ++i) {
+        producers.emplace_back(producer_function<Queue>, ref(queue_monitor), i, cref(workload), batch_size,
+                               ref(producer_stats[i]));
+        producer_placement.apply(producers.back(), i);
+    }
+
+    // Crear los hilos consumidores
+    for (int i = 0; i < num_consumers; ++i) {
+        consumers.emplace_back(consumer_function<Queue>, ref(queue_monitor), i, max_consumer_wait_time, cref(workload),
+                               batch_size, ref(consumer_stats[i]));
+        consumer_placement.apply(consumers.back(), i);
+    }
+
+    // Esperar a que todos los productores terminen
+    for (auto& prod : producers) {
+        prod.join();
+    }
+
+    // Indicar al monitor que los productores han terminado
+    queue_monitor.set_producers_done();
+
+    // Esperar a que todos los consumidores terminen
+    for (auto& cons : consumers) {
+        cons.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    sampling.store(false);
+    sampler.join();
+
+    // Resumen
+    ThreadStats produced;
+    ThreadStats consumed;
+    for (const ThreadStats& stats : producer_stats) {
+        produced.items += stats.items;
+        produced.wait.merge(stats.wait);
+    }
+    for (const ThreadStats& stats : consumer_stats) {
+        consumed.items += stats.items;
+        consumed.checksum += stats.checksum;
+        consumed.wait.merge(stats.wait);
+        consumed.latency.merge(stats.latency);
+        consumed.remote_items += stats.remote_items;
+        consumed.remote_latency.merge(stats.remote_latency);
+        if (stats.class_latency.size() > consumed.class_latency.size()) {
+            consumed.class_latency.resize(stats.class_latency.size());
+        }
+        for (size_t cls = 0; cls < stats.class_latency.size(); ++cls) {
+            consumed.class_latency[cls].merge(stats.class_latency[cls]);
+        }
+    }
+    double items_sum = 0.0;
+    double capacity_sum = 0.0;
+    size_t peak_items = 0;
+    for (const OccupancySample& sample : occupancy) {
+        items_sum += sample.items;
+        capacity_sum += sample.capacity;
+        peak_items = max(peak_items, sample.items);
+    }
+    size_t samples = max(occupancy.size(), (size_t)1);
+
+    cout << "Items producidos: " << produced.items << ", consumidos: " << consumed.items << " en " << seconds
+         << " s (" << (seconds > 0 ? consumed.items / seconds : 0.0) << " items/s)" << endl;
+    if (workload.payload_size > 0) {
+        cout << "Carga: " << workload.payload_size << " bytes por item, suma de control " << consumed.checksum;
+        if (workload.pool != nullptr) {
+            cout << ", arena de " << workload.pool->reserved_bytes() << " bytes";
+        }
+        cout << endl;
+    }
+    cout << "Métrica\tMuestras\tp50 (us)\tp90 (us)\tp99 (us)\tp99.9 (us)\tMáximo (us)" << endl;
+    print_latency_row(cout, "Espera enqueue", produced.wait);
+    print_latency_row(cout, "Espera dequeue", consumed.wait);
+    print_latency_row(cout, "Extremo a extremo", consumed.latency);
+    if (numa_topology().node_ids.size() > 1) {
+        print_latency_row(cout, "Entre nodos NUMA", consumed.remote_latency);
+    }
+    if (workload.class_mix.size() > 1) {
+        for (size_t cls = 0; cls < consumed.class_latency.size(); ++cls) {
+            print_latency_row(cout, ("Clase " + to_string(cls)).c_str(), consumed.class_latency[cls]);
+        }
+    }
+    cout << "Ocupación promedio: " << items_sum / samples << " items (máximo " << peak_items
+         << "), capacidad promedio: " << capacity_sum / samples << endl;
+    if (numa_topology().node_ids.size() > 1) {
+        cout << "Items que cruzaron de nodo NUMA: " << consumed.remote_items << " ("
+             << (consumed.items > 0 ? 100.0 * consumed.remote_items / consumed.items : 0.0) << "%)" << endl;
+    }
+
+    if (metrics_filename.empty()) {
+        return;
+    }
+    ofstream metrics(metrics_filename);
+    ofstream occupancy_file(metrics_filename + ".ocupacion.csv");
+    if (!metrics.is_open() || !occupancy_file.is_open()) {
+        cerr << "No se pudo escribir el archivo de métricas " << metrics_filename << endl;
+        return;
+    }
+    metrics << "rol,hilo,items,metrica,muestras,p50_us,p90_us,p99_us,p999_us,max_us,promedio_us\n";
+    for (int i = 0; i < num_producers; ++i) {
+        write_metrics_row(metrics, "productor", to_string(i), producer_stats[i].items, "espera_enqueue",
+                          producer_stats[i].wait);
+    }
+    for (int i = 0; i < num_consumers; ++i) {
+        write_metrics_row(metrics, "consumidor", to_string(i), consumer_stats[i].items, "espera_dequeue",
+                          consumer_stats[i].wait);
+        write_metrics_row(metrics, "consumidor", to_string(i), consumer_stats[i].items, "extremo_a_extremo",
+                          consumer_stats[i].latency);
+        write_metrics_row(metrics, "consumidor", to_string(i), consumer_stats[i].remote_items, "entre_nodos",
+                          consumer_stats[i].remote_latency);
+        for (size_t cls = 0; cls < consumer_stats[i].class_latency.size(); ++cls) {
+            const LatencyHistogram& latency = consumer_stats[i].class_latency[cls];
+            string metric = "clase_" + to_string(cls);
+            write_metrics_row(metrics, "consumidor", to_string(i), latency.samples(), metric.c_str(), latency);
+        }
+    }
+    write_metrics_row(metrics, "productor", "total", produced.items, "espera_enqueue", produced.wait);
+    write_metrics_row(metrics, "consumidor", "total", consumed.items, "espera_dequeue", consumed.wait);
+    write_metrics_row(metrics, "consumidor", "total", consumed.items, "extremo_a_extremo", consumed.latency);
+    write_metrics_row(metrics, "consumidor", "total", consumed.remote_items, "entre_nodos", consumed.remote_latency);
+    for (size_t cls = 0; cls < consumed.class_latency.size(); ++cls) {
+        write_metrics_row(metrics, "consumidor", "total", consumed.class_latency[cls].samples(),
+                          ("clase_" + to_string(cls)).c_str(), consumed.class_latency[cls]);
+    }
+
+    occupancy_file << "segundos,items,capacidad\n";
+    for (const OccupancySample& sample : occupancy) {
+        occupancy_file << sample.seconds << "," << sample.items << "," << sample.capacity << "\n";
     }
 }
 
@@ -154,6 +2181,27 @@ int main(int argc, char* argv[]) {
     int num_consumers = 5;             // Número de consumidores
     size_t initial_queue_size = 50;    // Tamaño inicial de la cola
     int max_consumer_wait_time = 1;    // Tiempo máximo de espera de los consumidores
+    bool bench = false;                // Microbenchmark de contención (-bench)
+    int bench_items = 1000000;         // Items totales por combinación en el benchmark (-n)
+    QueueType queue_type = QUEUE_MONITOR; // Cola central, MPMC sin bloqueo o robo de trabajo (-cola)
+    bool hash_distribution = false;    // Con robo de trabajo: repartir por hash en vez de por turno
+    int batch_size = 1;                // Items por operación de la cola (-lote, 1 = de a uno)
+    string metrics_filename;           // CSV de latencias por hilo y de ocupación (-metricas)
+    Workload workload;                 // Por defecto el modelo original: 100 items, 10 ms y 15 ms
+    workload.produce.kind = ServiceTime::FIXED;
+    workload.produce.nanoseconds = 10000000;
+    workload.consume.kind = ServiceTime::FIXED;
+    workload.consume.nanoseconds = 15000000;
+    workload.items_per_producer = 100;
+    workload.payload_size = 0;
+    workload.pool = nullptr;
+    bool use_payload_pool = false;     // Reservar las cargas en una arena (-arena)
+    ThreadPlacement producer_placement; // Afinidad de los productores (-afinidad-p)
+    ThreadPlacement consumer_placement; // Afinidad de los consumidores (-afinidad-c)
+    const vector<int>* queue_node_cpus = nullptr; // CPUs del nodo donde reservar la cola (-nodo-cola)
+    ClassPolicy class_policy;          // Clases de la cola con prioridades (-clases)
+    class_policy.strict = true;
+    class_policy.weights.assign(1, 1);
 
     // Parseo de argumentos de línea de comandos
     for (int i = 1; i < argc; ++i) {
@@ -165,6 +2213,83 @@ int main(int argc, char* argv[]) {
             initial_queue_size = atoi(argv[++i]); // Tamaño inicial de la cola
         } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
             max_consumer_wait_time = atoi(argv[++i]); // Tiempo máximo de espera
+        } else if (strcmp(argv[i], "-bench") == 0) {
+            bench = true;
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            bench_items = atoi(argv[++i]); // Items por combinación en el benchmark
+        } else if (strcmp(argv[i], "-lote") == 0 && i + 1 < argc) {
+            batch_size = atoi(argv[++i]); // Items por enqueue_bulk/dequeue_bulk
+        } else if ((strcmp(argv[i], "-tp") == 0 || strcmp(argv[i], "-tc") == 0) && i + 1 < argc) {
+            ServiceTime& service = (argv[i][2] == 'p') ? workload.produce : workload.consume;
+            if (!parse_service_time(argv[++i], service)) {
+                cerr << "Tiempo de servicio inválido (use cero, fijo:D, exp:D o giro:D con D en ns, us, ms o s): "
+                     << argv[i] << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-items") == 0 && i + 1 < argc) {
+            workload.items_per_producer = atoi(argv[++i]); // Items por productor
+        } else if (strcmp(argv[i], "-carga") == 0 && i + 1 < argc) {
+            workload.payload_size = strtoull(argv[++i], nullptr, 10); // Bytes de carga por item
+        } else if (strcmp(argv[i], "-arena") == 0) {
+            use_payload_pool = true;
+        } else if ((strcmp(argv[i], "-afinidad-p") == 0 || strcmp(argv[i], "-afinidad-c") == 0) && i + 1 < argc) {
+            ThreadPlacement& placement = (argv[i][10] == 'p') ? producer_placement : consumer_placement;
+            if (!parse_thread_placement(argv[++i], placement)) {
+                cerr << "Afinidad inválida (use cpus:LISTA como 0-3,8 o nodo:N con un nodo existente): " << argv[i]
+                     << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-nodo-cola") == 0 && i + 1 < argc) {
+            queue_node_cpus = numa_topology().cpus_of(atoi(argv[++i]));
+            if (queue_node_cpus == nullptr || queue_node_cpus->empty()) {
+                cerr << "El nodo NUMA " << argv[i] << " no existe o no tiene CPUs." << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-metricas") == 0 && i + 1 < argc) {
+            metrics_filename = argv[++i]; // CSV de métricas (y ARCHIVO.ocupacion.csv)
+        } else if (strcmp(argv[i], "-cola") == 0 && i + 1 < argc) {
+            string type = argv[++i];       // monitor, lockfree, robo o prioridad
+            if (type == "monitor") {
+                queue_type = QUEUE_MONITOR;
+            } else if (type == "lockfree") {
+                queue_type = QUEUE_LOCK_FREE;
+            } else if (type == "robo") {
+                queue_type = QUEUE_WORK_STEALING;
+            } else if (type == "prioridad") {
+                queue_type = QUEUE_PRIORITY;
+            } else {
+                cerr << "Tipo de cola desconocido (use monitor, lockfree, robo o prioridad): " << type << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-clases") == 0 && i + 1 < argc) {
+            if (!parse_class_policy(argv[++i], class_policy)) {
+                cerr << "Política de clases inválida (use estricta:N o ponderada:P0,P1,...): " << argv[i] << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-mezcla") == 0 && i + 1 < argc) {
+            // Proporción de items por clase, por ejemplo 10,90: 10% urgentes y 90% masivos
+            workload.class_mix.clear();
+            const char* cursor = argv[++i];
+            char* end = nullptr;
+            while (true) {
+                double share = strtod(cursor, &end);
+                if (end == cursor || share < 0) {
+                    cerr << "Mezcla de clases inválida (use proporciones como 10,90): " << argv[i] << endl;
+                    return 1;
+                }
+                workload.class_mix.push_back(share);
+                if (*end != ',') {
+                    break;
+                }
+                cursor = end + 1;
+            }
+        } else if (strcmp(argv[i], "-reparto") == 0 && i + 1 < argc) {
+            string mode = argv[++i];       // rr (por turno) o hash
+            if (mode != "rr" && mode != "hash") {
+                cerr << "Reparto desconocido (use rr o hash): " << mode << endl;
+                return 1;
+            }
+            hash_distribution = mode == "hash";
         } else {
             cerr << "Parámetro desconocido: " << argv[i] << endl;
             return 1;
@@ -177,40 +2302,81 @@ int main(int argc, char* argv[]) {
         cerr << "No se pudo abrir el archivo log.txt para escribir." << endl;
         return 1;
     }
+    AsyncLogger logger(log_file); // Hilo escritor del log, fuera de las secciones críticas
 
-    // Crear el Monitor de la cola circular
-    CircularQueueMonitor queue_monitor(initial_queue_size, log_file);
-
-    // Vectores para almacenar los hilos productores y consumidores
-    vector<thread> producers;
-    vector<thread> consumers;
-
-    int items_per_producer = 100; // Número de items que produce cada productor
-
-    // Crear los hilos productores
-    for (int i = 0; i < num_producers; ++i) {
-        producers.emplace_back(producer_function, ref(queue_monitor), i, items_per_producer);
+    if (workload.items_per_producer < 0) {
+        cerr << "La cantidad de items por productor (-items) no puede ser negativa." << endl;
+        return 1;
     }
-
-    // Crear los hilos consumidores
-    for (int i = 0; i < num_consumers; ++i) {
-        consumers.emplace_back(consumer_function, ref(queue_monitor), i, max_consumer_wait_time);
+    // Sin -mezcla, los items se reparten por igual entre las clases de -clases
+    if (workload.class_mix.empty() && class_policy.weights.size() > 1) {
+        workload.class_mix.assign(class_policy.weights.size(), 1.0);
+    }
+    if (class_policy.weights.size() > 1 && workload.class_mix.size() != class_policy.weights.size()) {
+        cerr << "-mezcla debe dar una proporción por cada clase de -clases." << endl;
+        return 1;
+    }
+    if (batch_size < 1) {
+        cerr << "El tamaño de lote (-lote) debe ser al menos 1." << endl;
+        return 1;
     }
 
-    // Esperar a que todos los productores terminen
-    for (auto& prod : producers) {
-        prod.join();
+    if (bench) {
+        if (initial_queue_size == 0 || bench_items <= 0) {
+            cerr << "El benchmark necesita -s y -n mayores que 0." << endl;
+            return 1;
+        }
+        run_benchmark(queue_type, hash_distribution, class_policy, initial_queue_size, bench_items, batch_size, logger);
+        logger.stop();
+        log_file.close();
+        return 0;
     }
 
-    // Indicar al monitor que los productores han terminado
-    queue_monitor.set_producers_done();
+    // La arena de cargas vive más que la cola: los items pendientes apuntan a sus bloques
+    unique_ptr<PayloadPool> payload_pool;
+    if (use_payload_pool && workload.payload_size > 0) {
+        payload_pool.reset(new PayloadPool(workload.payload_size));
+        workload.pool = payload_pool.get();
+    }
 
-    // Esperar a que todos los consumidores terminen
-    for (auto& cons : consumers) {
-        cons.join();
+    // Crear la cola elegida y ejecutar la simulación
+    switch (queue_type) {
+    case QUEUE_LOCK_FREE: {
+        ScopedAffinity on_queue_node(queue_node_cpus);
+        LockFreeQueue queue_monitor(initial_queue_size, logger);
+        on_queue_node.restore();
+        run_simulation(queue_monitor, num_producers, num_consumers, max_consumer_wait_time, workload, batch_size,
+                       producer_placement, consumer_placement, metrics_filename);
+        break;
+    }
+    case QUEUE_PRIORITY: {
+        ScopedAffinity on_queue_node(queue_node_cpus);
+        PriorityQueueMonitor queue_monitor(initial_queue_size, class_policy, logger);
+        on_queue_node.restore();
+        run_simulation(queue_monitor, num_producers, num_consumers, max_consumer_wait_time, workload, batch_size,
+                       producer_placement, consumer_placement, metrics_filename);
+        break;
+    }
+    case QUEUE_WORK_STEALING: {
+        ScopedAffinity on_queue_node(queue_node_cpus);
+        WorkStealingQueue queue_monitor(num_consumers, initial_queue_size, hash_distribution, logger);
+        on_queue_node.restore();
+        run_simulation(queue_monitor, num_producers, num_consumers, max_consumer_wait_time, workload, batch_size,
+                       producer_placement, consumer_placement, metrics_filename);
+        break;
+    }
+    default: {
+        ScopedAffinity on_queue_node(queue_node_cpus);
+        CircularQueueMonitor<Item> queue_monitor(initial_queue_size, logger);
+        on_queue_node.restore();
+        run_simulation(queue_monitor, num_producers, num_consumers, max_consumer_wait_time, workload, batch_size,
+                       producer_placement, consumer_placement, metrics_filename);
+        break;
+    }
     }
 
-    // Cerrar el archivo de log
+    // Vaciar el registro asíncrono y cerrar el archivo de log
+    logger.stop();
     log_file.close();
 
     return 0;